@@ -0,0 +1,44 @@
+#include "bench.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// 替换全局 operator new，在 allocation_scope 存活期间统计分配次数
+namespace {
+    std::atomic<bool> counting{ false };
+    std::atomic<u64> allocations{ 0 };
+}
+
+void* operator new(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace tools::bench {
+    allocation_scope::allocation_scope() {
+        start = allocations.load(std::memory_order_relaxed);
+        counting.store(true, std::memory_order_relaxed);
+    }
+
+    allocation_scope::~allocation_scope() {
+        counting.store(false, std::memory_order_relaxed);
+    }
+
+    u64 allocation_scope::count() const {
+        return allocations.load(std::memory_order_relaxed) - start;
+    }
+}
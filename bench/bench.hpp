@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../tools/base.hpp"
+#include "../tools/module/time.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace tools::bench {
+    // 基准测试条目
+    struct entry {
+        std::string name;
+        void (*func)();
+    };
+
+    // 全局基准测试注册表
+    inline std::vector<entry>& registry() {
+        static std::vector<entry> entries;
+        return entries;
+    }
+
+    // 静态注册辅助类
+    struct registrar {
+        registrar(const char* name, void (*func)()) {
+            registry().push_back({ name, func });
+        }
+    };
+
+    // 统计作用域内（所有线程）的堆分配次数
+    class allocation_scope {
+    public:
+        allocation_scope();
+        ~allocation_scope();
+
+        u64 count() const;
+
+    private:
+        u64 start = 0;
+    };
+
+    // 计算每秒操作数
+    inline f64 ops_per_second(u64 ops, tools::time::s elapsed) {
+        return elapsed.count() > 0 ? static_cast<f64>(ops) / elapsed.count() : 0.0;
+    }
+
+    // 运行选项，由命令行设置
+    struct options {
+        // measure 的预热次数与计时次数
+        u64 warmup = 1;
+        u64 repetitions = 10;
+        // 非空时把全部结果以 JSON 写入该文件
+        std::string json_path;
+    };
+
+    options& settings();
+
+    // 一项测量结果，名称为 "基准测试/标签"
+    struct result {
+        std::string name;
+        // 样本单位，如 "ns/op"、"us"、"ops/s"
+        std::string unit;
+        u64 samples = 0;
+        f64 min = 0;
+        f64 p50 = 0;
+        f64 p90 = 0;
+        f64 p99 = 0;
+        f64 max = 0;
+        f64 mean = 0;
+        // 单位为 ns/op 时按中位数换算的每秒操作数，否则为 0
+        f64 ops_per_second = 0;
+    };
+
+    // 当前进程中记录的全部结果
+    const std::vector<result>& results();
+
+    // 设置当前运行的基准测试名称，作为结果名称的前缀
+    void begin_entry(const std::string& name);
+
+    // 记录一组样本并打印分位数
+    result record(const std::string& label, std::vector<f64> samples, const std::string& unit);
+
+    // 记录单个数值（只写入报告，不打印）
+    result metric(const std::string& label, f64 value, const std::string& unit);
+
+    // 测量 body：每次调用执行 ops 个操作；先预热 warmup 次，再计时 repetitions 次，
+    // 每次的 ns/op 作为一个样本
+    template<typename F>
+    result measure(const std::string& label, u64 ops, F&& body) {
+        for (u64 i = 0; i < settings().warmup; ++i) body();
+
+        std::vector<f64> samples;
+        samples.reserve(settings().repetitions);
+        for (u64 i = 0; i < settings().repetitions; ++i) {
+            auto start = tools::time::time_now();
+            body();
+            tools::time::ns elapsed = tools::time::time_now() - start;
+            samples.push_back(elapsed.count() / static_cast<f64>(ops ? ops : 1));
+        }
+        return record(label, std::move(samples), "ns/op");
+    }
+
+    // 写出 JSON 报告
+    void write_json(std::ostream& out);
+}
+
+// 定义并注册一个基准测试
+#define TOOLS_BENCH(name)                                                       \
+    static void name();                                                         \
+    static ::tools::bench::registrar name##_registrar_(#name, &name);           \
+    static void name()
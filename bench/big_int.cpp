@@ -0,0 +1,55 @@
+#include "bench.hpp"
+#include "../tools/module/big_number.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+    // 指定位数的随机十进制数（首位非 0）
+    std::string random_digits(u64 digits, std::mt19937_64& rng) {
+        std::string s;
+        s.reserve(digits);
+        s.push_back(static_cast<char>('1' + rng() % 9));
+        for (u64 i = 1; i < digits; ++i) s.push_back(static_cast<char>('0' + rng() % 10));
+        return s;
+    }
+}
+
+// 大整数加、乘、除与十进制转换在不同位数下的耗时
+TOOLS_BENCH(big_int_arithmetic) {
+    using tools::big_int::big_int;
+    std::mt19937_64 rng(42);
+
+    for (u64 digits : { 20, 150, 1200 }) {
+        std::string a_text = random_digits(digits, rng);
+        std::string b_text = random_digits(digits / 2 + 1, rng);
+        big_int a(a_text);
+        big_int b(b_text);
+        std::string label = std::to_string(digits) + "_digits";
+        u64 ops = digits <= 20 ? 20000 : digits <= 150 ? 2000 : 100;
+
+        big_int sink;
+        tools::bench::measure(label + "/add", ops * 10, [&] {
+            for (u64 i = 0; i < ops * 10; ++i) sink = a + b;
+        });
+        tools::bench::measure(label + "/mul", ops, [&] {
+            for (u64 i = 0; i < ops; ++i) sink = a * b;
+        });
+        // 按位移减的除法代价与位数的平方成正比，大位数只测少量次数
+        u64 div_ops = digits <= 20 ? ops : digits <= 150 ? 20 : 1;
+        tools::bench::measure(label + "/div", div_ops, [&] {
+            for (u64 i = 0; i < div_ops; ++i) sink = a / b;
+        });
+        tools::bench::measure(label + "/parse", ops, [&] {
+            for (u64 i = 0; i < ops; ++i) sink = big_int(a_text);
+        });
+        tools::bench::measure(label + "/to_string", div_ops, [&] {
+            for (u64 i = 0; i < div_ops; ++i) a.to_string();
+        });
+
+        // 结果校验：(a / b) * b + a % b == a
+        big_int check = (a / b) * b + a % b;
+        std::cout << "  " << label << " " << (check == a ? "ok" : "MISMATCH") << std::endl;
+    }
+}
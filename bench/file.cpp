@@ -0,0 +1,622 @@
+#include "bench.hpp"
+#include "../tools/module/file.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    namespace fs = std::filesystem;
+
+    // 基准测试使用的临时目录，结束时删除
+    struct scratch_dir {
+        fs::path path;
+
+        explicit scratch_dir(const std::string& name)
+            : path(fs::temp_directory_path() / name) {
+            fs::remove_all(path);
+            fs::create_directories(path);
+        }
+
+        ~scratch_dir() {
+            std::error_code ec;
+            fs::remove_all(path, ec);
+        }
+    };
+
+    std::vector<tools::file::byte> make_data(u64 size) {
+        std::vector<tools::file::byte> data(size);
+        for (u64 i = 0; i < size; ++i) data[i] = static_cast<tools::file::byte>('a' + i % 26);
+        return data;
+    }
+}
+
+// file_task_pool 写入、读取许多小文件的耗时（每个文件一个请求）
+TOOLS_BENCH(file_small_files) {
+    constexpr u64 files = 1000;
+    constexpr u64 size = 4 * 1024;
+    scratch_dir dir("tools_box_bench_small");
+    auto data = make_data(size);
+
+    std::vector<fs::path> paths;
+    for (u64 i = 0; i < files; ++i) paths.push_back(dir.path / ("f" + std::to_string(i)));
+
+    tools::file::file_task_pool files_pool;
+    tools::bench::measure("write_4k", files, [&] {
+        for (auto& p : paths) files_pool.add_write(p, data, tools::file::mode::cover);
+        files_pool.wait();
+    });
+
+    std::vector<std::vector<tools::file::byte>> out(files);
+    tools::bench::measure("read_4k", files, [&] {
+        for (u64 i = 0; i < files; ++i) files_pool.add_read(paths[i], out[i]);
+        files_pool.wait();
+    });
+
+    bool ok = true;
+    for (auto& o : out) ok = ok && o == data;
+    std::cout << "  " << files << " files x " << size << " bytes " << (ok ? "ok" : "MISMATCH") << std::endl;
+    std::cout << "  write chunk " << files_pool.write_latency().summary() << std::endl;
+    std::cout << "  read chunk  " << files_pool.read_latency().summary() << std::endl;
+    tools::bench::metric("write_chunk_p99", files_pool.write_latency().percentile(99).count() / 1000, "us");
+    tools::bench::metric("read_chunk_p99", files_pool.read_latency().percentile(99).count() / 1000, "us");
+}
+
+// 少量大文件按 16 MiB 分块写入、读取的吞吐量
+TOOLS_BENCH(file_large_files) {
+    constexpr u64 files = 2;
+    constexpr u64 size = 64 * 1024 * 1024;
+    constexpr u64 rounds = 3;
+    scratch_dir dir("tools_box_bench_large");
+    auto data = make_data(size);
+
+    std::vector<fs::path> paths;
+    for (u64 i = 0; i < files; ++i) paths.push_back(dir.path / ("f" + std::to_string(i)));
+
+    tools::file::file_task_pool files_pool(nullptr, 16 * 1024 * 1024);
+    std::vector<std::vector<tools::file::byte>> out(files);
+    std::vector<f64> write_rate;
+    std::vector<f64> read_rate;
+    for (u64 r = 0; r < rounds; ++r) {
+        auto start = tools::time::time_now();
+        for (auto& p : paths) files_pool.add_write(p, data, tools::file::mode::cover);
+        files_pool.wait();
+        tools::time::s elapsed = tools::time::time_now() - start;
+        write_rate.push_back(files * size / 1048576.0 / elapsed.count());
+
+        start = tools::time::time_now();
+        for (u64 i = 0; i < files; ++i) files_pool.add_read(paths[i], out[i]);
+        files_pool.wait();
+        elapsed = tools::time::time_now() - start;
+        read_rate.push_back(files * size / 1048576.0 / elapsed.count());
+    }
+    tools::bench::record("write_64m", write_rate, "MiB/s");
+    tools::bench::record("read_64m", read_rate, "MiB/s");
+
+    bool ok = true;
+    for (auto& o : out) ok = ok && o == data;
+    std::cout << "  " << files << " files x " << size / 1048576 << " MiB " << (ok ? "ok" : "MISMATCH") << std::endl;
+}
+
+// 向少数几个文件追加许多小记录（test.cpp 中的使用方式）
+TOOLS_BENCH(file_small_appends) {
+    constexpr u64 files = 8;
+    constexpr u64 appends = 2000;
+    constexpr u64 record = 64;
+    scratch_dir dir("tools_box_bench_append");
+    auto data = make_data(record);
+
+    std::vector<fs::path> paths;
+    for (u64 i = 0; i < files; ++i) paths.push_back(dir.path / ("f" + std::to_string(i)));
+
+    tools::file::file_task_pool files_pool;
+    u64 rounds = 0;
+    tools::bench::measure("append_64b", appends, [&] {
+        for (u64 i = 0; i < appends; ++i) files_pool.add_write(paths[i % files], data, tools::file::mode::addend);
+        files_pool.wait();
+        ++rounds;
+    });
+
+    // 统计实际落盘的字节数（并发追加不应互相覆盖）
+    u64 written = 0;
+    for (auto& p : paths) written += fs::file_size(p);
+    u64 expected = rounds * appends * record;
+    std::cout << "  appended " << written << " of " << expected << " bytes" << std::endl;
+    tools::bench::metric("bytes_kept", static_cast<f64>(written) / static_cast<f64>(expected), "ratio");
+}
+
+namespace {
+    // 原来的读取方式：每次打开文件、定位、读取、关闭
+    bool fstream_read(const fs::path& path, tools::file::byte* data, u64 size, u64 offset) {
+        std::fstream file(path, std::ios::in | std::ios::binary);
+        if (!file.is_open()) return false;
+        file.seekg(offset);
+        file.read(data, size);
+        return static_cast<bool>(file);
+    }
+
+    // 通过句柄缓存按偏移量读取
+    bool cached_read(tools::file::handle_cache& cache, const fs::path& path, tools::file::byte* data, u64 size, u64 offset) {
+        std::error_code ec;
+        auto file = cache.acquire(path, tools::file::access::read, ec);
+        return file && file->read_at(data, size, offset, ec) == size;
+    }
+}
+
+// 句柄缓存加 pread 与每次打开 fstream 的对比：许多小文件随机读取整个文件，少数大文件随机读取 64 KiB，
+// 以及多个线程共用一个句柄读取同一个大文件
+TOOLS_BENCH(file_handle_cache) {
+    constexpr u64 small_files = 1000;
+    constexpr u64 small_size = 4 * 1024;
+    constexpr u64 small_reads = 20000;
+    scratch_dir dir("tools_box_bench_handles");
+    auto small = make_data(small_size);
+
+    std::vector<fs::path> paths;
+    for (u64 i = 0; i < small_files; ++i) {
+        paths.push_back(dir.path / ("s" + std::to_string(i)));
+        std::ofstream(paths.back(), std::ios::binary).write(small.data(), small_size);
+    }
+    std::vector<u64> order(small_reads);
+    std::mt19937_64 random(3);
+    for (auto& o : order) o = random() % small_files;
+
+    std::vector<tools::file::byte> buffer(small_size);
+    u64 failures = 0;
+    tools::bench::measure("small_fstream", small_reads, [&] {
+        for (u64 i : order) failures += !fstream_read(paths[i], buffer.data(), small_size, 0);
+    });
+    tools::file::handle_cache all(small_files * 2);
+    tools::bench::measure("small_cached", small_reads, [&] {
+        for (u64 i : order) failures += !cached_read(all, paths[i], buffer.data(), small_size, 0);
+    });
+    // 预算小于文件数：大部分读取都要重新打开并关闭最久未用的句柄
+    tools::file::handle_cache churn(64);
+    tools::bench::measure("small_cached_budget_64", small_reads, [&] {
+        for (u64 i : order) failures += !cached_read(churn, paths[i], buffer.data(), small_size, 0);
+    });
+    auto churn_stats = churn.stats();
+    std::cout << "  budget 64  open " << churn_stats.open << "  hits " << churn_stats.hits
+        << "  misses " << churn_stats.misses << "  evictions " << churn_stats.evictions << std::endl;
+
+    constexpr u64 huge_files = 2;
+    constexpr u64 huge_size = 64 * 1024 * 1024;
+    constexpr u64 block = 64 * 1024;
+    constexpr u64 huge_reads = 4000;
+    auto huge = make_data(huge_size);
+    std::vector<fs::path> huge_paths;
+    for (u64 i = 0; i < huge_files; ++i) {
+        huge_paths.push_back(dir.path / ("h" + std::to_string(i)));
+        std::ofstream(huge_paths.back(), std::ios::binary).write(huge.data(), huge_size);
+    }
+    std::vector<std::pair<u64, u64>> blocks(huge_reads);
+    for (auto& b : blocks) b = { random() % huge_files, random() % (huge_size / block) * block };
+
+    buffer.resize(block);
+    tools::bench::measure("huge_fstream_64k", huge_reads, [&] {
+        for (auto& [f, offset] : blocks) failures += !fstream_read(huge_paths[f], buffer.data(), block, offset);
+    });
+    tools::bench::measure("huge_cached_64k", huge_reads, [&] {
+        for (auto& [f, offset] : blocks) failures += !cached_read(all, huge_paths[f], buffer.data(), block, offset);
+    });
+
+    // 多个线程同时读取同一个大文件
+    constexpr u64 threads = 4;
+    auto parallel = [&](bool cached) {
+        std::atomic<u64> failed{ 0 };
+        std::vector<std::thread> workers;
+        for (u64 t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::vector<tools::file::byte> local(block);
+                for (u64 i = t; i < huge_reads; i += threads) {
+                    bool ok = cached
+                        ? cached_read(all, huge_paths[0], local.data(), block, blocks[i].second)
+                        : fstream_read(huge_paths[0], local.data(), block, blocks[i].second);
+                    failed.fetch_add(!ok, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+        failures += failed.load();
+    };
+    tools::bench::measure("shared_fstream_4_threads", huge_reads, [&] { parallel(false); });
+    tools::bench::measure("shared_cached_4_threads", huge_reads, [&] { parallel(true); });
+
+    auto s = all.stats();
+    std::cout << "  cache  open " << s.open << "  hits " << s.hits << "  misses " << s.misses
+        << "  failures " << failures << std::endl;
+}
+
+// io_uring 在不同队列深度下随机读取 4 KiB 的 IOPS，与同样数量的线程阻塞读取对比；
+// 以及 file_task_pool 两种执行方式读写许多小文件
+TOOLS_BENCH(file_uring_iops) {
+    if (!tools::file::io_ring::supported()) {
+        std::cout << "  io_uring not supported, skipped" << std::endl;
+        return;
+    }
+
+    constexpr u64 size = 64 * 1024 * 1024;
+    constexpr u64 block = 4096;
+    constexpr u64 reads = 20000;
+    scratch_dir dir("tools_box_bench_uring");
+    auto path = dir.path / "data";
+    {
+        auto data = make_data(size);
+        std::ofstream(path, std::ios::binary).write(data.data(), size);
+    }
+    std::error_code ec;
+    auto file = tools::file::file_handle::open(path, tools::file::access::read, ec);
+
+    std::mt19937_64 random(5);
+    std::vector<u64> offsets(reads);
+    for (auto& o : offsets) o = random() % (size / block) * block;
+    std::vector<tools::file::byte> buffers(reads * block);
+
+    for (u32 depth : { 1u, 8u, 64u }) {
+        tools::file::io_ring ring(depth);
+        std::atomic<u64> failed{ 0 };
+        auto iops = tools::bench::measure("uring_qd" + std::to_string(depth), reads, [&] {
+            tools::thread::latch done(reads);
+            std::vector<tools::file::io_operation_ptr> batch;
+            batch.reserve(reads);
+            for (u64 i = 0; i < reads; ++i) {
+                auto op = std::make_unique<tools::file::io_operation>();
+                op->file = file;
+                op->data = buffers.data() + i * block;
+                op->size = block;
+                op->offset = offsets[i];
+                op->on_complete = [&](tools::file::io_operation& op) {
+                    failed.fetch_add(op.done != block, std::memory_order_relaxed);
+                    done.count_down();
+                };
+                batch.push_back(std::move(op));
+            }
+            ring.submit(batch);
+            done.wait();
+        });
+        auto s = ring.stats();
+        tools::bench::metric("uring_qd" + std::to_string(depth) + "_iops", iops.ops_per_second, "ops/s");
+
+        // 同样数量的线程各自阻塞读取
+        tools::thread::pool pool(depth);
+        auto threads = tools::bench::measure("threads_" + std::to_string(depth), reads, [&] {
+            tools::thread::latch done(reads);
+            for (u64 i = 0; i < reads; ++i) {
+                pool.insert([&, i] {
+                    std::error_code read_ec;
+                    failed.fetch_add(file->read_at(buffers.data() + i * block, block, offsets[i], read_ec) != block,
+                        std::memory_order_relaxed);
+                    done.count_down();
+                });
+            }
+            done.wait();
+        });
+        tools::bench::metric("threads_" + std::to_string(depth) + "_iops", threads.ops_per_second, "ops/s");
+        std::cout << "  qd " << depth << "  enter calls " << s.enter_calls << "  submitted " << s.submitted
+            << "  failures " << failed.load() << std::endl;
+    }
+
+    // file_task_pool：许多 4 KiB 小文件，io_uring 与线程池
+    constexpr u64 files = 1000;
+    auto small = make_data(block);
+    std::vector<fs::path> paths;
+    for (u64 i = 0; i < files; ++i) paths.push_back(dir.path / ("s" + std::to_string(i)));
+    std::vector<std::vector<tools::file::byte>> out(files);
+    for (auto backend : { tools::file::io_backend::automatic, tools::file::io_backend::thread_pool }) {
+        tools::file::file_pool_options options;
+        options.backend = backend;
+        tools::file::file_task_pool pool(options);
+        std::string name = pool.uses_io_uring() ? "pool_uring" : "pool_threads";
+        tools::bench::measure(name + "_write_4k", files, [&] {
+            tools::thread::latch done(files);
+            for (auto& p : paths) pool.add_write(p, small, tools::file::mode::cover, [&] { done.count_down(); });
+            done.wait();
+        });
+        tools::bench::measure(name + "_read_4k", files, [&] {
+            tools::thread::latch done(files);
+            for (u64 i = 0; i < files; ++i) pool.add_read(paths[i], out[i], [&] { done.count_down(); });
+            done.wait();
+        });
+    }
+}
+
+namespace {
+    // 按 8 字节累加，模拟对整个文件的一次顺序扫描
+    u64 checksum(const tools::file::byte* data, u64 size) {
+        u64 sum = 0;
+        u64 i = 0;
+        for (; i + 8 <= size; i += 8) {
+            u64 word;
+            std::memcpy(&word, data + i, 8);
+            sum += word;
+        }
+        for (; i < size; ++i) sum += static_cast<u8>(data[i]);
+        return sum;
+    }
+
+    // 从页缓存中丢弃文件，使下一次读取来自磁盘（不支持时无效果）
+    void drop_cache(const fs::path& path) {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+#else
+        (void)path;
+#endif
+    }
+}
+
+// 扫描 1 GiB 文件：读入缓冲区后扫描，与映射后直接扫描（顺序提示、线程池预读）
+TOOLS_BENCH(file_map_scan) {
+    constexpr u64 size = 1024 * 1024 * 1024;
+    constexpr u64 rounds = 3;
+    scratch_dir dir("tools_box_bench_map");
+    auto path = dir.path / "data";
+    {
+        auto block = make_data(16 * 1024 * 1024);
+        std::ofstream out(path, std::ios::binary);
+        for (u64 i = 0; i < size / block.size(); ++i) out.write(block.data(), block.size());
+    }
+
+    // 预读分块需要线程池
+    tools::file::file_pool_options options;
+    options.block_size = 16 * 1024 * 1024;
+    options.backend = tools::file::io_backend::thread_pool;
+    tools::file::file_task_pool files_pool(options);
+    u64 expected = 0;
+    {
+        std::vector<tools::file::byte> data;
+        files_pool.add_read(path, data);
+        files_pool.wait();
+        expected = checksum(data.data(), data.size());
+    }
+
+    bool ok = true;
+    bool huge = false;
+    for (bool cold : { false, true }) {
+        std::string suffix = cold ? "_cold" : "_warm";
+        std::vector<f64> read_rate;
+        std::vector<f64> map_rate;
+        std::vector<f64> willneed_rate;
+        for (u64 r = 0; r < rounds; ++r) {
+            // 读入缓冲区后扫描（缓冲区在计时外释放）
+            {
+                if (cold) drop_cache(path);
+                std::vector<tools::file::byte> data;
+                auto start = tools::time::time_now();
+                files_pool.add_read(path, data);
+                files_pool.wait();
+                ok = ok && checksum(data.data(), data.size()) == expected;
+                tools::time::s elapsed = tools::time::time_now() - start;
+                read_rate.push_back(size / 1048576.0 / elapsed.count());
+            }
+
+            // 映射后按顺序扫描，缺页时由内核预读
+            {
+                if (cold) drop_cache(path);
+                tools::file::mapped_file file;
+                auto start = tools::time::time_now();
+                files_pool.add_map(path, file, tools::file::map_hint::sequential);
+                files_pool.wait();
+                ok = ok && checksum(file.data(), file.size()) == expected;
+                tools::time::s elapsed = tools::time::time_now() - start;
+                map_rate.push_back(size / 1048576.0 / elapsed.count());
+                huge = file.huge_pages();
+            }
+
+            // 映射后先由线程池分块预读，再扫描
+            {
+                if (cold) drop_cache(path);
+                tools::file::mapped_file file;
+                auto start = tools::time::time_now();
+                files_pool.add_map(path, file, tools::file::map_hint::willneed);
+                files_pool.wait();
+                ok = ok && checksum(file.data(), file.size()) == expected;
+                tools::time::s elapsed = tools::time::time_now() - start;
+                willneed_rate.push_back(size / 1048576.0 / elapsed.count());
+            }
+        }
+        tools::bench::record("read_scan" + suffix, read_rate, "MiB/s");
+        tools::bench::record("map_scan" + suffix, map_rate, "MiB/s");
+        tools::bench::record("map_willneed_scan" + suffix, willneed_rate, "MiB/s");
+    }
+    std::cout << "  1 GiB x " << rounds << " rounds " << (ok ? "ok" : "MISMATCH")
+        << "  huge pages " << (huge ? "requested" : "unavailable") << std::endl;
+}
+
+// 每个读取请求完成后立即处理该文件，与全部读完后再统一处理；并检查失败请求的结果
+TOOLS_BENCH(file_request_results) {
+    constexpr u64 files = 64;
+    constexpr u64 size = 4 * 1024 * 1024;
+    scratch_dir dir("tools_box_bench_results");
+    auto data = make_data(size);
+    u64 expected = checksum(data.data(), size);
+
+    std::vector<fs::path> paths;
+    for (u64 i = 0; i < files; ++i) paths.push_back(dir.path / ("f" + std::to_string(i)));
+    tools::file::file_pool_options options;
+    options.backend = tools::file::io_backend::thread_pool;
+    tools::file::file_task_pool files_pool(options);
+    for (auto& p : paths) files_pool.add_write(p, data, tools::file::mode::cover);
+    files_pool.wait();
+
+    std::vector<std::vector<tools::file::byte>> out(files);
+    std::atomic<u64> good{ 0 };
+    std::atomic<u64> bytes{ 0 };
+    std::atomic<u64> requests{ 0 };
+
+    // 全部读完后再计算校验和
+    tools::bench::measure("wait_then_process", files, [&] {
+        for (u64 i = 0; i < files; ++i) files_pool.add_read(paths[i], out[i]);
+        files_pool.wait();
+        for (auto& o : out) good.fetch_add(checksum(o.data(), o.size()) == expected, std::memory_order_relaxed);
+    });
+
+    // 每个文件读完时在完成线程上计算校验和
+    tools::bench::measure("process_on_complete", files, [&] {
+        tools::thread::latch done(files);
+        for (u64 i = 0; i < files; ++i) {
+            files_pool.add_read_result(paths[i], out[i], [&, i](const tools::file::file_result& result) {
+                bytes.fetch_add(result.bytes, std::memory_order_relaxed);
+                requests.fetch_add(1, std::memory_order_relaxed);
+                good.fetch_add(result.ok() and checksum(out[i].data(), out[i].size()) == expected,
+                    std::memory_order_relaxed);
+                done.count_down();
+            });
+        }
+        done.wait();
+    });
+
+    // 不存在的文件与目录：应在回调中得到错误码
+    std::vector<tools::file::byte> missing;
+    tools::file::file_result missing_result;
+    tools::file::file_result dir_result;
+    {
+        tools::thread::latch done(2);
+        files_pool.add_read_result(dir.path / "missing", missing, [&](const tools::file::file_result& result) {
+            missing_result = result;
+            done.count_down();
+        });
+        files_pool.add_write_result(dir.path, data, tools::file::mode::cover, [&](const tools::file::file_result& result) {
+            dir_result = result;
+            done.count_down();
+        });
+        done.wait();
+    }
+
+    std::cout << "  " << files << " files x " << size / 1048576 << " MiB  checksums ok " << good.load()
+        << "  bytes per request " << bytes.load() / std::max<u64>(1, requests.load()) << std::endl;
+    std::cout << "  missing file: " << missing_result.error.message()
+        << "  directory: " << dir_result.error.message() << std::endl;
+}
+
+// 追加日志的吞吐量：单线程与多线程追加 64 字节记录，不同的组提交策略；
+// 对比每次追加都打开、定位、写入、关闭文件（原来的追加方式）
+TOOLS_BENCH(file_append_log) {
+    constexpr u64 record = 64;
+    constexpr u64 appends = 200000;
+    constexpr u64 producers = 4;
+    scratch_dir dir("tools_box_bench_append_log");
+    auto data = make_data(record);
+
+    // 原来的方式：每次追加打开文件
+    {
+        constexpr u64 naive_appends = 20000;
+        auto path = dir.path / "naive";
+        tools::bench::measure("fstream_append", naive_appends, [&] {
+            for (u64 i = 0; i < naive_appends; ++i) {
+                std::ofstream file(path, std::ios::binary | std::ios::app);
+                file.write(data.data(), record);
+            }
+        });
+    }
+
+    struct policy_case {
+        std::string name;
+        tools::file::sync_policy sync;
+    };
+    std::vector<policy_case> cases(3);
+    cases[0].name = "nosync";
+    cases[1].name = "sync_1m";
+    cases[1].sync.bytes = 1024 * 1024;
+    cases[2].name = "sync_5ms";
+    cases[2].sync.interval = tools::time::ms(5);
+
+    tools::thread::pool writers(1);
+    for (auto& c : cases) {
+        for (u64 threads : { u64(1), producers }) {
+            auto path = dir.path / (c.name + "_" + std::to_string(threads));
+            std::string name = c.name + "_t" + std::to_string(threads);
+            tools::file::append_log_stats stats;
+            u64 rounds = 0;
+            {
+                tools::file::append_log_options options;
+                options.thread_pool = &writers;
+                options.sync = c.sync;
+                tools::file::append_log log(path, options);
+                auto result = tools::bench::measure(name, appends, [&] {
+                    std::vector<std::thread> producer_threads;
+                    for (u64 t = 0; t < threads; ++t) {
+                        producer_threads.emplace_back([&] {
+                            for (u64 i = 0; i < appends / threads; ++i) log.append(data);
+                        });
+                    }
+                    for (auto& thread : producer_threads) thread.join();
+                    log.flush();
+                    ++rounds;
+                });
+                tools::bench::metric(name + "_mib", result.ops_per_second * record / 1048576.0, "MiB/s");
+                stats = log.stats();
+            }
+            u64 expected = rounds * (appends / threads) * threads * record;
+            std::cout << "  " << name << "  appends per write " << stats.appends / std::max<u64>(1, stats.writes)
+                << "  syncs " << stats.syncs << "  stalls " << stats.stalls
+                << "  " << (fs::file_size(path) == expected ? "ok" : "MISMATCH") << std::endl;
+        }
+    }
+}
+
+// wait() 在请求的完成回调结束后才返回：回调耗时 20 ms 并写入标志，wait() 之后标志必须已写入
+TOOLS_BENCH(file_wait_covers_callbacks) {
+    scratch_dir dir("tools_box_bench_wait_callbacks");
+    auto path = dir.path / "f";
+    auto data = make_data(64 * 1024);
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    tools::thread::pool pool(2);
+    struct backend_case {
+        const char* name;
+        tools::file::io_backend backend;
+        tools::thread::pool* thread_pool;
+    };
+    const backend_case cases[] = {
+        { "thread_pool        ", tools::file::io_backend::thread_pool, nullptr },
+        { "automatic + pool   ", tools::file::io_backend::automatic, &pool },
+        { "automatic, no pool ", tools::file::io_backend::automatic, nullptr },
+    };
+    for (const auto& c : cases) {
+        tools::file::file_pool_options options;
+        options.backend = c.backend;
+        options.thread_pool = c.thread_pool;
+        tools::file::file_task_pool files(options);
+
+        constexpr u64 rounds = 5;
+        u64 early = 0;
+        for (u64 i = 0; i < rounds; ++i) {
+            std::vector<tools::file::byte> in;
+            std::atomic<bool> finished{ false };
+            files.add_read(path, in, [&finished] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                finished.store(true, std::memory_order_release);
+            });
+            files.wait();
+            early += !finished.load(std::memory_order_acquire);
+            // 失败时等回调结束，避免访问已销毁的局部变量
+            while (!finished.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+        std::cout << "  " << c.name << (files.uses_io_uring() ? "uring " : "pool  ")
+            << "  returned early " << early << "/" << rounds << "  " << (early == 0 ? "ok" : "FAILED") << std::endl;
+        if (early != 0) {
+            std::abort();
+        }
+    }
+}
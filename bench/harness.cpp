@@ -0,0 +1,175 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace tools::bench {
+    namespace {
+        std::string current_entry;
+
+        std::vector<result>& storage() {
+            static std::vector<result> all;
+            return all;
+        }
+
+        // 最近秩法分位数，samples 已排序
+        f64 percentile(const std::vector<f64>& samples, f64 p) {
+            if (samples.empty()) return 0;
+            size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<f64>(samples.size())));
+            return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+        }
+
+        result store(result r) {
+            storage().push_back(r);
+            return r;
+        }
+
+        std::string full_name(const std::string& label) {
+            if (current_entry.empty()) return label;
+            if (label.empty()) return current_entry;
+            return current_entry + "/" + label;
+        }
+
+        void write_string(std::ostream& out, const std::string& s) {
+            out << '"';
+            for (char c : s) {
+                switch (c) {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                            << std::dec << std::setfill(' ');
+                    }
+                    else {
+                        out << c;
+                    }
+                }
+            }
+            out << '"';
+        }
+
+        // NaN 与无穷在 JSON 中写为 null
+        void write_number(std::ostream& out, f64 v) {
+            if (std::isfinite(v)) out << v;
+            else out << "null";
+        }
+
+        std::string compiler() {
+#if defined(__clang__)
+            return "clang " __clang_version__;
+#elif defined(__GNUC__)
+            return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+            return "msvc " + std::to_string(_MSC_VER);
+#else
+            return "unknown";
+#endif
+        }
+    }
+
+    options& settings() {
+        static options opts;
+        return opts;
+    }
+
+    const std::vector<result>& results() {
+        return storage();
+    }
+
+    void begin_entry(const std::string& name) {
+        current_entry = name;
+    }
+
+    result record(const std::string& label, std::vector<f64> samples, const std::string& unit) {
+        result r;
+        r.name = full_name(label);
+        r.unit = unit;
+        r.samples = samples.size();
+        if (!samples.empty()) {
+            std::sort(samples.begin(), samples.end());
+            f64 sum = 0;
+            for (f64 v : samples) sum += v;
+            r.min = samples.front();
+            r.max = samples.back();
+            r.mean = sum / static_cast<f64>(samples.size());
+            r.p50 = percentile(samples, 50);
+            r.p90 = percentile(samples, 90);
+            r.p99 = percentile(samples, 99);
+            if (unit == "ns/op" && r.p50 > 0) r.ops_per_second = 1e9 / r.p50;
+        }
+
+        std::cout << "  " << label << "  p50 " << r.p50 << " " << unit
+            << "  p90 " << r.p90 << "  p99 " << r.p99
+            << "  min " << r.min << "  max " << r.max;
+        if (r.ops_per_second > 0) std::cout << "  " << static_cast<u64>(r.ops_per_second) << " ops/s";
+        std::cout << "  (" << r.samples << " samples)" << std::endl;
+        return store(std::move(r));
+    }
+
+    result metric(const std::string& label, f64 value, const std::string& unit) {
+        result r;
+        r.name = full_name(label);
+        r.unit = unit;
+        r.samples = 1;
+        r.min = r.p50 = r.p90 = r.p99 = r.max = r.mean = value;
+        if (unit == "ns/op" && value > 0) r.ops_per_second = 1e9 / value;
+        if (unit == "ops/s") r.ops_per_second = value;
+        return store(std::move(r));
+    }
+
+    void write_json(std::ostream& out) {
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        char timestamp[32] = {};
+        std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        out << std::setprecision(9);
+        out << "{\n  \"context\": {\n";
+        out << "    \"timestamp\": ";
+        write_string(out, timestamp);
+        out << ",\n    \"compiler\": ";
+        write_string(out, compiler());
+#ifdef NDEBUG
+        out << ",\n    \"build\": \"release\"";
+#else
+        out << ",\n    \"build\": \"debug\"";
+#endif
+        out << ",\n    \"hardware_concurrency\": " << std::thread::hardware_concurrency();
+        out << ",\n    \"warmup\": " << settings().warmup;
+        out << ",\n    \"repetitions\": " << settings().repetitions;
+        out << "\n  },\n  \"benchmarks\": [";
+
+        bool first = true;
+        for (const result& r : results()) {
+            out << (first ? "\n" : ",\n") << "    {\"name\": ";
+            write_string(out, r.name);
+            out << ", \"unit\": ";
+            write_string(out, r.unit);
+            out << ", \"samples\": " << r.samples;
+            out << ", \"min\": ";
+            write_number(out, r.min);
+            out << ", \"p50\": ";
+            write_number(out, r.p50);
+            out << ", \"p90\": ";
+            write_number(out, r.p90);
+            out << ", \"p99\": ";
+            write_number(out, r.p99);
+            out << ", \"max\": ";
+            write_number(out, r.max);
+            out << ", \"mean\": ";
+            write_number(out, r.mean);
+            out << ", \"ops_per_second\": ";
+            write_number(out, r.ops_per_second);
+            out << "}";
+            first = false;
+        }
+        out << "\n  ]\n}\n";
+    }
+}
@@ -0,0 +1,71 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+    void usage() {
+        std::cout << "用法: tools_box_bench [名称过滤] [选项]\n"
+            << "  --list               列出基准测试\n"
+            << "  --warmup N           measure 的预热次数（默认 1）\n"
+            << "  --repetitions N      measure 的计时次数（默认 10）\n"
+            << "  --json FILE          把结果以 JSON 写入 FILE\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string filter;
+    bool list = false;
+    auto& opts = tools::bench::settings();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--list") {
+            list = true;
+        }
+        else if (arg == "--warmup" && has_value) {
+            opts.warmup = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--repetitions" && has_value) {
+            opts.repetitions = std::max<u64>(1, std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--json" && has_value) {
+            opts.json_path = argv[++i];
+        }
+        else if (arg == "--help" || arg == "-h" || arg.rfind("--", 0) == 0) {
+            usage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        else {
+            filter = arg;
+        }
+    }
+
+    for (auto& entry : tools::bench::registry()) {
+        if (!filter.empty() && entry.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        if (list) {
+            std::cout << entry.name << std::endl;
+            continue;
+        }
+        std::cout << "== " << entry.name << " ==" << std::endl;
+        tools::bench::begin_entry(entry.name);
+        entry.func();
+    }
+    tools::bench::begin_entry("");
+
+    if (!list && !opts.json_path.empty()) {
+        std::ofstream out(opts.json_path);
+        if (!out) {
+            std::cerr << "cannot open " << opts.json_path << std::endl;
+            return 1;
+        }
+        tools::bench::write_json(out);
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include "bench.hpp"
+#include "../tools/module/memory.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // 逐个分配后立即释放，以及成批分配后成批释放，返回 ns/次（一次分配加一次释放）
+    template<typename Alloc, typename Free>
+    void run_patterns(const char* name, size_t size, Alloc alloc, Free release) {
+        constexpr u64 rounds = 5000000;
+        auto start = tools::time::time_now();
+        for (u64 i = 0; i < rounds; ++i) {
+            void* p = alloc(size);
+            *static_cast<volatile char*>(p) = 1;
+            release(p, size);
+        }
+        tools::time::ns single = tools::time::time_now() - start;
+
+        constexpr u64 batch = 1024;
+        constexpr u64 batches = rounds / batch;
+        std::vector<void*> blocks(batch);
+        start = tools::time::time_now();
+        for (u64 b = 0; b < batches; ++b) {
+            for (u64 i = 0; i < batch; ++i) {
+                blocks[i] = alloc(size);
+                *static_cast<volatile char*>(blocks[i]) = 1;
+            }
+            for (u64 i = 0; i < batch; ++i) release(blocks[i], size);
+        }
+        tools::time::ns batched = tools::time::time_now() - start;
+
+        std::string label = name;
+        label.erase(label.find_last_not_of(' ') + 1);
+        label += "/" + std::to_string(size);
+        tools::bench::metric(label + "/single", single.count() / rounds, "ns/op");
+        tools::bench::metric(label + "/batch", batched.count() / (batches * batch), "ns/op");
+        std::cout << "  " << name << "  single " << single.count() / rounds << " ns"
+            << "  batch " << batched.count() / (batches * batch) << " ns" << std::endl;
+    }
+
+    // threads 个线程各自成批分配、释放，返回每秒分配次数
+    template<typename Alloc, typename Free>
+    f64 run_threads(u64 threads, size_t size, Alloc alloc, Free release) {
+        constexpr u64 per_thread = 2000000;
+        constexpr u64 batch = 256;
+        std::vector<std::thread> workers;
+        auto start = tools::time::time_now();
+        for (u64 t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                std::vector<void*> blocks(batch);
+                for (u64 n = 0; n < per_thread; n += batch) {
+                    for (u64 i = 0; i < batch; ++i) blocks[i] = alloc(size);
+                    for (u64 i = 0; i < batch; ++i) release(blocks[i], size);
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+        tools::time::s elapsed = tools::time::time_now() - start;
+        return tools::bench::ops_per_second(threads * per_thread, elapsed);
+    }
+
+    void* malloc_alloc(size_t size) {
+        return std::malloc(size);
+    }
+
+    void malloc_free(void* p, size_t) {
+        std::free(p);
+    }
+
+    void* pool_alloc(size_t size) {
+        return tools::memory::size_class_pool::allocate(size);
+    }
+
+    void pool_free(void* p, size_t size) {
+        tools::memory::size_class_pool::deallocate(p, size);
+    }
+}
+
+// 分级对象池与 malloc 的分配、释放耗时（单线程与多线程）
+TOOLS_BENCH(memory_pool_vs_malloc) {
+    for (size_t size : { 32, 128, 512 }) {
+        std::cout << size << " bytes" << std::endl;
+        run_patterns("malloc", size, malloc_alloc, malloc_free);
+        run_patterns("pool  ", size, pool_alloc, pool_free);
+    }
+
+    size_t hw = std::max<size_t>(2, std::thread::hardware_concurrency());
+    for (u64 threads = 1; threads <= hw * 2; threads <<= 1) {
+        f64 m = run_threads(threads, 64, malloc_alloc, malloc_free);
+        f64 p = run_threads(threads, 64, pool_alloc, pool_free);
+        tools::bench::metric("malloc/" + std::to_string(threads) + "_threads", m, "ops/s");
+        tools::bench::metric("pool/" + std::to_string(threads) + "_threads", p, "ops/s");
+        std::cout << threads << " threads 64 bytes  malloc " << static_cast<u64>(m) << " ops/s"
+            << "  pool " << static_cast<u64>(p) << " ops/s" << std::endl;
+    }
+
+    // 一个线程分配、另一个线程释放：块经全局仓库整批回到分配线程
+    constexpr u64 blocks = 1000000;
+    std::vector<void*> handoff(blocks);
+    u64 heap_allocations = 0;
+    auto start = tools::time::time_now();
+    for (int round = 0; round < 5; ++round) {
+        tools::bench::allocation_scope scope;
+        std::thread producer([&] {
+            for (u64 i = 0; i < blocks; ++i) handoff[i] = pool_alloc(64);
+        });
+        producer.join();
+        std::thread consumer([&] {
+            for (u64 i = 0; i < blocks; ++i) pool_free(handoff[i], 64);
+        });
+        consumer.join();
+        if (round > 0) heap_allocations += scope.count();
+    }
+    tools::time::ns elapsed = tools::time::time_now() - start;
+    tools::bench::metric("cross_thread_free", elapsed.count() / (5 * blocks), "ns/op");
+    std::cout << "cross-thread free  " << elapsed.count() / (5 * blocks) << " ns/block"
+        << "  heap allocations after warm-up (incl. std::thread) " << heap_allocations << std::endl;
+
+    for (const auto& s : tools::memory::size_class_pool::all_stats()) {
+        std::cout << "  class " << s.block_size << "  chunks " << s.chunks
+            << "  reserved " << s.bytes_reserved / 1024 << " KiB"
+            << "  fetched " << s.batches_fetched << "  flushed " << s.batches_flushed
+            << "  depot " << s.depot_batches << std::endl;
+    }
+}
+
+// 单调分配区与 pmr 容器：逐个 malloc/free 与分配区整体重置的对比
+TOOLS_BENCH(memory_arena) {
+    constexpr u64 rounds = 200;
+    constexpr u64 per_round = 10000;
+
+    std::vector<void*> blocks(per_round);
+    auto start = tools::time::time_now();
+    for (u64 r = 0; r < rounds; ++r) {
+        for (u64 i = 0; i < per_round; ++i) blocks[i] = std::malloc(16 + (i & 63));
+        for (u64 i = 0; i < per_round; ++i) std::free(blocks[i]);
+    }
+    tools::time::ns malloc_time = tools::time::time_now() - start;
+
+    tools::memory::monotonic_arena arena;
+    u64 heap_allocations = 0;
+    start = tools::time::time_now();
+    for (u64 r = 0; r < rounds; ++r) {
+        tools::bench::allocation_scope scope;
+        for (u64 i = 0; i < per_round; ++i) blocks[i] = arena.allocate(16 + (i & 63), 16);
+        arena.reset();
+        if (r > 0) heap_allocations += scope.count();
+    }
+    tools::time::ns arena_time = tools::time::time_now() - start;
+    auto s = arena.stats();
+    tools::bench::metric("malloc", malloc_time.count() / (rounds * per_round), "ns/op");
+    tools::bench::metric("arena", arena_time.count() / (rounds * per_round), "ns/op");
+    std::cout << "malloc/free " << malloc_time.count() / (rounds * per_round) << " ns"
+        << "  arena " << arena_time.count() / (rounds * per_round) << " ns"
+        << "  chunks " << s.chunks << "  reserved " << s.bytes_reserved / 1024 << " KiB"
+        << "  heap allocations after first round " << heap_allocations << std::endl;
+
+    // std::pmr::list 插入与销毁：默认资源、分级池、分配区
+    auto fill = [&](std::pmr::memory_resource* resource) {
+        auto t = tools::time::time_now();
+        for (u64 r = 0; r < 20; ++r) {
+            std::pmr::list<u64> items(resource);
+            for (u64 i = 0; i < per_round * 10; ++i) items.push_back(i);
+        }
+        tools::time::ns elapsed = tools::time::time_now() - t;
+        return elapsed.count() / (20 * per_round * 10);
+    };
+    tools::memory::arena_resource frame;
+    f64 default_ns = fill(std::pmr::new_delete_resource());
+    f64 pool_ns = fill(tools::memory::default_pool_resource());
+    f64 arena_ns = 0;
+    {
+        auto t = tools::time::time_now();
+        for (u64 r = 0; r < 20; ++r) {
+            {
+                std::pmr::list<u64> items(&frame);
+                for (u64 i = 0; i < per_round * 10; ++i) items.push_back(i);
+            }
+            frame.reset();
+        }
+        tools::time::ns elapsed = tools::time::time_now() - t;
+        arena_ns = elapsed.count() / (20 * per_round * 10);
+    }
+    tools::bench::metric("pmr_list/new_delete", default_ns, "ns/op");
+    tools::bench::metric("pmr_list/pool_resource", pool_ns, "ns/op");
+    tools::bench::metric("pmr_list/arena_resource", arena_ns, "ns/op");
+    std::cout << "pmr::list push_back  new_delete " << default_ns << " ns"
+        << "  pool_resource " << pool_ns << " ns"
+        << "  arena_resource " << arena_ns << " ns" << std::endl;
+
+    // 标准分配器
+    start = tools::time::time_now();
+    for (u64 r = 0; r < 20; ++r) {
+        std::list<u64, tools::memory::pool_allocator<u64>> items;
+        for (u64 i = 0; i < per_round * 10; ++i) items.push_back(i);
+    }
+    tools::time::ns allocator_time = tools::time::time_now() - start;
+    std::cout << "std::list<pool_allocator> push_back " << allocator_time.count() / (20 * per_round * 10) << " ns" << std::endl;
+}
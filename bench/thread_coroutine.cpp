@@ -0,0 +1,101 @@
+#include "bench.hpp"
+#include "../tools/module/thread.hpp"
+#include "../tools/module/file/file.hpp"
+
+#include <iostream>
+#include <vector>
+
+namespace {
+    namespace coro = tools::thread::coro;
+
+    coro::task<u64> leaf(u64 value) {
+        co_return value;
+    }
+
+    // 顺序等待 n 个子协程：每次创建帧、对称转移、返回
+    coro::task<u64> chain(u64 n) {
+        u64 sum = 0;
+        for (u64 i = 0; i < n; ++i) {
+            sum += co_await leaf(i);
+        }
+        co_return sum;
+    }
+
+    // 在线程池上往返 hops 次
+    coro::task<u64> hop(tools::thread::pool& pool, u64 hops) {
+        u64 count = 0;
+        for (u64 i = 0; i < hops; ++i) {
+            co_await coro::schedule(pool);
+            ++count;
+        }
+        co_return count;
+    }
+
+    coro::task<tools::time::ms> sleep_once(tools::thread::pool& pool, tools::time::ms duration) {
+        auto start = tools::time::time_now();
+        co_await coro::sleep_for(pool, duration);
+        co_return tools::time::ms(tools::time::time_now() - start);
+    }
+
+    coro::task<bool> file_round_trip(tools::file::file_task_pool& files, tools::file::fs::path path, u64 size) {
+        std::vector<tools::file::byte> out(size);
+        for (u64 i = 0; i < size; ++i) out[i] = static_cast<tools::file::byte>(i * 31);
+        auto written = co_await tools::file::async_write(files, path, out);
+        std::vector<tools::file::byte> in;
+        auto read = co_await tools::file::async_read(files, path, in);
+        co_return written.ok() and read.ok() and read.bytes == size and in == out;
+    }
+}
+
+// 协程的创建与恢复开销、帧分配次数、线程池调度往返、定时器精度与文件读写等待
+TOOLS_BENCH(thread_coroutine) {
+    constexpr u64 awaits = 2000000;
+    constexpr u64 hops = 200000;
+
+    // 预热帧缓存
+    coro::sync_wait(chain(1000));
+
+    auto before = coro::frame_allocator::stats();
+    u64 allocated = 0;
+    u64 sum = 0;
+    tools::time::s chain_time{ 0 };
+    {
+        tools::bench::allocation_scope allocations;
+        auto start = tools::time::time_now();
+        sum = coro::sync_wait(chain(awaits));
+        chain_time = tools::time::time_now() - start;
+        allocated = allocations.count();
+    }
+    auto after = coro::frame_allocator::stats();
+    tools::bench::metric("await", tools::time::ns(chain_time).count() / awaits, "ns/op");
+    std::cout << "await    " << static_cast<u64>(tools::bench::ops_per_second(awaits, chain_time)) << " ops/s"
+        << "  " << tools::time::ns(chain_time).count() / awaits << " ns/await"
+        << "  heap allocs " << allocated
+        << "  frame heap allocs " << after.heap_allocations - before.heap_allocations
+        << "  " << (sum == awaits * (awaits - 1) / 2 ? "ok" : "MISMATCH") << std::endl;
+
+    for (auto mode : { tools::thread::schedule_mode::shared_queue, tools::thread::schedule_mode::work_stealing }) {
+        tools::thread::pool pool(2, mode);
+        auto start = tools::time::time_now();
+        u64 count = coro::sync_wait(hop(pool, hops));
+        tools::time::s elapsed = tools::time::time_now() - start;
+        tools::bench::metric(mode == tools::thread::schedule_mode::work_stealing ? "hop/work_stealing" : "hop/shared_queue",
+            tools::bench::ops_per_second(hops, elapsed), "ops/s");
+        std::cout << "schedule " << (mode == tools::thread::schedule_mode::work_stealing ? "stealing" : "shared  ")
+            << "  " << static_cast<u64>(tools::bench::ops_per_second(hops, elapsed)) << " hops/s"
+            << "  " << (count == hops ? "ok" : "MISMATCH") << std::endl;
+    }
+
+    {
+        tools::thread::pool pool(2);
+        tools::time::ms slept = coro::sync_wait(sleep_once(pool, tools::time::ms(5)));
+        tools::bench::metric("sleep_5ms", slept.count(), "ms");
+        std::cout << "timer    5 ms -> " << slept.count() << " ms" << std::endl;
+
+        tools::file::file_task_pool files(&pool);
+        auto path = tools::file::fs::temp_directory_path() / "tools_box_coroutine.bin";
+        bool ok = coro::sync_wait(file_round_trip(files, path, 40 * tools::size::mi));
+        tools::file::fs::remove(path);
+        std::cout << "file     40 MiB write+read " << (ok ? "ok" : "MISMATCH") << std::endl;
+    }
+}
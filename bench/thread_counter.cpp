@@ -0,0 +1,62 @@
+#include "bench.hpp"
+#include "../tools/module/thread.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // threads 个线程各累加 per_thread 次
+    template<typename F>
+    f64 run_adds(u64 threads, u64 per_thread, F&& add) {
+        std::vector<std::thread> workers;
+        auto start = tools::time::time_now();
+        for (u64 t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                for (u64 i = 0; i < per_thread; ++i) add();
+            });
+        }
+        for (auto& w : workers) w.join();
+        tools::time::s elapsed = tools::time::time_now() - start;
+        return tools::bench::ops_per_second(threads * per_thread, elapsed);
+    }
+}
+
+// 单个原子变量与分片计数器在多线程累加下的吞吐量，以及读取（汇总）代价
+TOOLS_BENCH(thread_sharded_counter) {
+    constexpr u64 per_thread = 5000000;
+    size_t hw = std::max<size_t>(2, std::thread::hardware_concurrency());
+
+    for (size_t threads = 1; threads <= hw * 2; threads <<= 1) {
+        std::atomic<u64> single{ 0 };
+        tools::thread::sharded_counter sharded;
+        tools::thread::inflight_counter inflight;
+
+        f64 single_ops = run_adds(threads, per_thread, [&] { single.fetch_add(1, std::memory_order_relaxed); });
+        f64 sharded_ops = run_adds(threads, per_thread, [&] { sharded.add(); });
+        f64 inflight_ops = run_adds(threads, per_thread, [&] { inflight.begin(); inflight.end(); });
+
+        bool ok = single.load() == threads * per_thread && sharded.value() == threads * per_thread
+            && inflight.pending() == 0 && inflight.snapshot().finished == threads * per_thread;
+        std::string label = std::to_string(threads) + "_threads";
+        tools::bench::metric("atomic/" + label, single_ops, "ops/s");
+        tools::bench::metric("sharded/" + label, sharded_ops, "ops/s");
+        tools::bench::metric("inflight/" + label, inflight_ops, "ops/s");
+        std::cout << threads << " threads"
+            << "  atomic " << static_cast<u64>(single_ops) << " ops/s"
+            << "  sharded " << static_cast<u64>(sharded_ops) << " ops/s"
+            << "  inflight begin+end " << static_cast<u64>(inflight_ops) << " ops/s"
+            << "  " << (ok ? "ok" : "MISMATCH") << std::endl;
+    }
+
+    tools::thread::inflight_counter counter;
+    constexpr u64 reads = 1000000;
+    u64 sink = 0;
+    auto start = tools::time::time_now();
+    for (u64 i = 0; i < reads; ++i) sink += counter.snapshot().pending;
+    tools::time::s elapsed = tools::time::time_now() - start;
+    tools::bench::metric("snapshot", tools::time::ns(elapsed).count() / reads, "ns/op");
+    std::cout << "snapshot " << counter.cell_count() << " cells  "
+        << tools::time::ns(elapsed).count() / reads << " ns/read" << (sink ? "" : "") << std::endl;
+}
@@ -0,0 +1,116 @@
+#include "bench.hpp"
+#include "../tools/module/thread.hpp"
+#include "../tools/module/net/base.hpp"
+
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    // 互斥锁保护的 unordered_map，作为对照
+    class locked_map {
+    public:
+        std::optional<u64> find(u64 key) const {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = map.find(key);
+            if (it == map.end()) return std::nullopt;
+            return it->second;
+        }
+
+        void upsert(u64 key, u64 value) {
+            std::lock_guard<std::mutex> lock(mutex);
+            map[key] = value;
+        }
+
+        void erase(u64 key) {
+            std::lock_guard<std::mutex> lock(mutex);
+            map.erase(key);
+        }
+
+    private:
+        mutable std::mutex mutex;
+        std::unordered_map<u64, u64> map;
+    };
+
+    // threads 个线程各执行 per_thread 次操作，write_percent% 为写（其中十分之一为删除）
+    template<typename Map>
+    f64 run_mix(Map& map, u64 threads, u64 per_thread, u64 key_range, u64 write_percent) {
+        std::vector<std::thread> workers;
+        std::atomic<u64> hits{ 0 };
+        auto start = tools::time::time_now();
+        for (u64 t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::mt19937_64 random(t + 1);
+                u64 local_hits = 0;
+                for (u64 i = 0; i < per_thread; ++i) {
+                    u64 r = random();
+                    u64 key = r % key_range;
+                    u64 op = (r >> 40) % 1000;
+                    if (op >= write_percent * 10) {
+                        if (map.find(key)) ++local_hits;
+                    }
+                    else if (op < write_percent) {
+                        map.erase(key);
+                    }
+                    else {
+                        map.upsert(key, i);
+                    }
+                }
+                hits.fetch_add(local_hits, std::memory_order_relaxed);
+            });
+        }
+        for (auto& w : workers) w.join();
+        tools::time::s elapsed = tools::time::time_now() - start;
+        return tools::bench::ops_per_second(threads * per_thread, elapsed);
+    }
+}
+
+// 并发哈希表与互斥锁 + unordered_map 的扩展性：读多写少与读写各半
+TOOLS_BENCH(thread_map_scaling) {
+    constexpr u64 per_thread = 1000000;
+    constexpr u64 key_range = 1 << 18;
+
+    size_t hw = std::max<size_t>(2, std::thread::hardware_concurrency());
+    for (u64 write_percent : { u64(5), u64(50) }) {
+        for (size_t threads = 1; threads <= hw * 2; threads <<= 1) {
+            tools::thread::data::concurrent_map<u64, u64> sharded;
+            locked_map locked;
+            for (u64 k = 0; k < key_range; k += 2) {
+                sharded.upsert(k, k);
+                locked.upsert(k, k);
+            }
+            f64 sharded_ops = run_mix(sharded, threads, per_thread, key_range, write_percent);
+            f64 locked_ops = run_mix(locked, threads, per_thread, key_range, write_percent);
+            std::string label = "writes_" + std::to_string(write_percent) + "/" + std::to_string(threads) + "_threads";
+            tools::bench::metric("concurrent_map/" + label, sharded_ops, "ops/s");
+            tools::bench::metric("locked_map/" + label, locked_ops, "ops/s");
+            std::cout << "writes " << write_percent << "%  " << threads << " threads"
+                << "  concurrent_map " << static_cast<u64>(sharded_ops) << " ops/s"
+                << "  mutex+unordered_map " << static_cast<u64>(locked_ops) << " ops/s"
+                << "  x" << sharded_ops / locked_ops << std::endl;
+        }
+    }
+
+    // 以 ip_address__ 为键，校验各操作的语义
+    tools::thread::data::concurrent_map<tools::net::ip_address__, std::string> peers;
+    bool ok = true;
+    for (u16 port = 0; port < 1000; ++port) {
+        ok = ok && peers.insert({ "10.0.0.1", port }, "peer" + std::to_string(port));
+    }
+    ok = ok && !peers.insert({ "10.0.0.1", 7 }, "duplicate");
+    ok = ok && peers.find({ "10.0.0.1", 7 }) == std::optional<std::string>("peer7");
+    ok = ok && !peers.upsert({ "10.0.0.1", 7 }, "seven");
+    ok = ok && peers.update({ "10.0.0.1", 7 }, [](const std::string& v) { return v + "!"; });
+    ok = ok && peers.find({ "10.0.0.1", 7 }) == std::optional<std::string>("seven!");
+    ok = ok && peers.erase({ "10.0.0.1", 8 }) && !peers.contains({ "10.0.0.1", 8 });
+    u64 visited = 0;
+    peers.for_each([&](const tools::net::ip_address__&, const std::string&) { ++visited; });
+    ok = ok && peers.size() == 999 && visited == 999;
+    peers.clear();
+    ok = ok && peers.empty() && !peers.find({ "10.0.0.1", 1 });
+    std::cout << "ip_address__ keys " << (ok ? "ok" : "MISMATCH") << std::endl;
+}
@@ -0,0 +1,122 @@
+#include "bench.hpp"
+#include "../tools/module/thread.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#endif
+
+namespace {
+    // 内存带宽型内核：每个分区由一个任务初始化（首次访问决定内存所在节点），再多轮求和
+    struct partitions {
+        std::vector<std::unique_ptr<u64[]>> data;
+        u64 size;
+
+        partitions(u64 count, u64 size) : data(count), size(size) {}
+    };
+
+    // 将分区轮流交给 pools 中的线程池初始化与处理，返回每秒处理的字节数
+    f64 run_kernel(std::vector<tools::thread::pool*> pools, u64 count, u64 size, u64 rounds, u64& checksum) {
+        partitions parts(count, size);
+
+        auto for_each_partition = [&](auto&& func) {
+            std::vector<tools::thread::future<void>> futures;
+            for (u64 k = 0; k < count; ++k) {
+                futures.push_back(pools[k % pools.size()]->submit([&func, k] { func(k); }));
+            }
+            for (auto& f : futures) f.get();
+        };
+
+        for_each_partition([&](u64 k) {
+            parts.data[k].reset(new u64[size]);
+            for (u64 i = 0; i < size; ++i) parts.data[k][i] = i ^ k;
+        });
+
+        std::vector<u64> sums(count, 0);
+        auto start = tools::time::time_now();
+        for (u64 r = 0; r < rounds; ++r) {
+            for_each_partition([&](u64 k) {
+                u64 sum = 0;
+                const u64* p = parts.data[k].get();
+                for (u64 i = 0; i < size; ++i) sum += p[i];
+                sums[k] += sum;
+            });
+        }
+        tools::time::s elapsed = tools::time::time_now() - start;
+
+        checksum = 0;
+        for (u64 s : sums) checksum += s;
+        return tools::bench::ops_per_second(count * size * sizeof(u64) * rounds, elapsed);
+    }
+
+    // 列出本进程所有线程的名称
+    std::vector<std::string> thread_names() {
+        std::vector<std::string> names;
+#ifndef _WIN32
+        if (DIR* dir = opendir("/proc/self/task")) {
+            while (dirent* entry = readdir(dir)) {
+                if (entry->d_name[0] == '.') continue;
+                std::ifstream file(std::string("/proc/self/task/") + entry->d_name + "/comm");
+                std::string name;
+                if (std::getline(file, name)) names.push_back(name);
+            }
+            closedir(dir);
+        }
+#endif
+        return names;
+    }
+}
+
+// NUMA 拓扑、绑核与按节点拆分线程池对内存带宽型内核的影响
+TOOLS_BENCH(thread_pool_numa_locality) {
+    constexpr u64 total_bytes = u64(256) << 20;
+    constexpr u64 rounds = 8;
+
+    auto topology = tools::thread::numa_topology();
+    u64 cpu_count = 0;
+    for (auto& node : topology) {
+        std::cout << "node " << node.id << "  cpus";
+        for (u32 cpu : node.cpus) std::cout << " " << cpu;
+        std::cout << std::endl;
+        cpu_count += node.cpus.size();
+    }
+
+    // 每个 CPU 4 个分区，便于负载均衡
+    const u64 count = cpu_count * 4;
+    const u64 size = total_bytes / sizeof(u64) / count;
+    u64 checksum = 0;
+
+    {
+        tools::thread::pool_options options;
+        options.thread_count = cpu_count;
+        tools::thread::pool pool(options);
+        f64 bytes = run_kernel({ &pool }, count, size, rounds, checksum);
+        tools::bench::metric("unpinned", bytes / (1 << 30), "GiB/s");
+        std::cout << "unpinned pool       " << bytes / (1 << 30) << " GiB/s  (checksum " << checksum << ")" << std::endl;
+    }
+    {
+        tools::thread::pool_options options;
+        options.thread_count = cpu_count;
+        options.numa_aware = true;
+        tools::thread::pool pool(options);
+        f64 bytes = run_kernel({ &pool }, count, size, rounds, checksum);
+        tools::bench::metric("numa_aware", bytes / (1 << 30), "GiB/s");
+        std::cout << "numa-aware pool     " << bytes / (1 << 30) << " GiB/s  (checksum " << checksum << ")" << std::endl;
+    }
+    {
+        auto pools = tools::thread::make_numa_pools();
+        std::vector<tools::thread::pool*> raw;
+        for (auto& p : pools) raw.push_back(p.get());
+        f64 bytes = run_kernel(raw, count, size, rounds, checksum);
+        tools::bench::metric("per_node_pools", bytes / (1 << 30), "GiB/s");
+        std::cout << "per-node pools (" << pools.size() << ")  " << bytes / (1 << 30) << " GiB/s  (checksum " << checksum << ")" << std::endl;
+
+        std::cout << "thread names:";
+        for (auto& name : thread_names()) std::cout << " " << name;
+        std::cout << std::endl;
+    }
+}
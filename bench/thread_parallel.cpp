@@ -0,0 +1,147 @@
+#include "bench.hpp"
+#include "../tools/module/thread.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // 参与测试的线程池大小：1, 2, 4 ... 直到硬件线程数
+    std::vector<size_t> pool_sizes() {
+        std::vector<size_t> sizes;
+        size_t hw = std::max<size_t>(2, std::thread::hardware_concurrency());
+        for (size_t n = 1; n < hw; n <<= 1) sizes.push_back(n);
+        sizes.push_back(hw);
+        return sizes;
+    }
+
+    // 多次运行取最快一次
+    template<typename F>
+    tools::time::s best_of(u64 repetitions, F&& func) {
+        tools::time::s best{ 0 };
+        for (u64 i = 0; i < repetitions; ++i) {
+            auto start = tools::time::time_now();
+            func();
+            tools::time::s elapsed = tools::time::time_now() - start;
+            if (i == 0 || elapsed < best) best = elapsed;
+        }
+        return best;
+    }
+}
+
+// 数据并行算法的扩展性：同一个线程池上重复调用，验证结果并与串行版本比较
+TOOLS_BENCH(thread_parallel_scaling) {
+    constexpr u64 n = 1 << 23;
+    constexpr u64 repetitions = 5;
+
+    std::vector<u64> a(n), b(n), c(n);
+    std::iota(b.begin(), b.end(), u64(0));
+    std::fill(c.begin(), c.end(), u64(1));
+    std::vector<u64> unsorted(n);
+    std::mt19937_64 random(42);
+    for (auto& v : unsorted) v = random();
+
+    // 串行基准
+    tools::time::s serial_for = best_of(repetitions, [&] {
+        for (u64 i = 0; i < n; ++i) a[i] = b[i] * 2 + c[i];
+    });
+    u64 expected_sum = 0;
+    tools::time::s serial_reduce = best_of(repetitions, [&] {
+        expected_sum = std::accumulate(b.begin(), b.end(), u64(0));
+    });
+    std::vector<u64> expected_sorted;
+    tools::time::s serial_sort = best_of(1, [&] {
+        expected_sorted = unsorted;
+        std::sort(expected_sorted.begin(), expected_sorted.end());
+    });
+    tools::bench::metric("serial/for", tools::bench::ops_per_second(n, serial_for), "elem/s");
+    tools::bench::metric("serial/reduce", tools::bench::ops_per_second(n, serial_reduce), "elem/s");
+    tools::bench::metric("serial/sort", tools::bench::ops_per_second(n, serial_sort), "elem/s");
+    std::cout << "serial   "
+        << "  for " << static_cast<u64>(tools::bench::ops_per_second(n, serial_for)) << " elem/s"
+        << "  reduce " << static_cast<u64>(tools::bench::ops_per_second(n, serial_reduce)) << " elem/s"
+        << "  sort " << static_cast<u64>(tools::bench::ops_per_second(n, serial_sort)) << " elem/s" << std::endl;
+
+    for (size_t threads : pool_sizes()) {
+        tools::thread::pool pool(threads, tools::thread::schedule_mode::work_stealing);
+        bool ok = true;
+
+        tools::time::s for_time = best_of(repetitions, [&] {
+            tools::thread::parallel_for(pool, u64(0), n, [&](u64 begin, u64 end) {
+                for (u64 i = begin; i < end; ++i) a[i] = b[i] * 2 + c[i];
+            });
+        });
+        ok = ok && a[n - 1] == (n - 1) * 2 + 1;
+
+        u64 sum = 0;
+        tools::time::s reduce_time = best_of(repetitions, [&] {
+            sum = tools::thread::parallel_reduce(pool, u64(0), n, u64(0),
+                [&](u64 begin, u64 end, u64 value) {
+                    for (u64 i = begin; i < end; ++i) value += b[i];
+                    return value;
+                },
+                std::plus<>());
+        });
+        ok = ok && sum == expected_sum;
+
+        tools::time::s transform_time = best_of(repetitions, [&] {
+            tools::thread::parallel_transform(pool, b.begin(), b.end(), a.begin(), [](u64 v) { return v * 3; });
+        });
+        ok = ok && a[n - 1] == (n - 1) * 3;
+
+        std::vector<u64> sorted;
+        tools::time::s sort_time = best_of(1, [&] {
+            sorted = unsorted;
+            tools::thread::parallel_sort(pool, sorted.begin(), sorted.end());
+        });
+        ok = ok && sorted == expected_sorted;
+
+        std::string label = std::to_string(threads) + "_threads";
+        tools::bench::metric("for/" + label, tools::bench::ops_per_second(n, for_time), "elem/s");
+        tools::bench::metric("reduce/" + label, tools::bench::ops_per_second(n, reduce_time), "elem/s");
+        tools::bench::metric("transform/" + label, tools::bench::ops_per_second(n, transform_time), "elem/s");
+        tools::bench::metric("sort/" + label, tools::bench::ops_per_second(n, sort_time), "elem/s");
+        std::cout << threads << " threads"
+            << "  for " << static_cast<u64>(tools::bench::ops_per_second(n, for_time)) << " elem/s"
+            << "  reduce " << static_cast<u64>(tools::bench::ops_per_second(n, reduce_time)) << " elem/s"
+            << "  transform " << static_cast<u64>(tools::bench::ops_per_second(n, transform_time)) << " elem/s"
+            << "  sort " << static_cast<u64>(tools::bench::ops_per_second(n, sort_time)) << " elem/s"
+            << "  " << (ok ? "ok" : "MISMATCH") << std::endl;
+    }
+}
+
+// 嵌套调用与异常：工作线程内部再次调用并行算法不会死锁，异常传回调用线程
+TOOLS_BENCH(thread_parallel_nested) {
+    tools::thread::pool pool(2, tools::thread::schedule_mode::work_stealing);
+    std::atomic<u64> total{ 0 };
+
+    auto start = tools::time::time_now();
+    tools::thread::parallel_for(pool, 0, 64, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            tools::thread::parallel_for(pool, 0, 1000, [&](int lo, int hi) {
+                total.fetch_add(static_cast<u64>(hi - lo), std::memory_order_relaxed);
+            });
+        }
+    }, 1);
+    tools::time::s elapsed = tools::time::time_now() - start;
+
+    bool caught = false;
+    try {
+        tools::thread::parallel_for(pool, 0, 1000, [](int begin, int) {
+            if (begin == 0) throw std::runtime_error("expected");
+        });
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+
+    // 线程池仍可使用
+    auto f = pool.submit([] { return 1; });
+    std::cout << "nested " << (total.load() == 64000 ? "ok" : "MISMATCH")
+        << "  " << elapsed.count() * 1e3 << " ms"
+        << "  exception " << (caught ? "ok" : "MISSING")
+        << "  pool after " << (f.get() == 1 ? "ok" : "BROKEN") << std::endl;
+}
@@ -0,0 +1,418 @@
+#include "bench.hpp"
+#include "../tools/module/thread.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+    // 微小任务：几乎没有计算量，用于测量调度开销
+    void tiny_task() {
+        volatile u64 sink = 0;
+        sink = sink + 1;
+    }
+
+    // 从外部提交 spawners 个任务，每个任务在工作线程内再提交 fan_out 个微小任务
+    f64 run_fan_out(size_t threads, tools::thread::schedule_mode mode, u64 spawners, u64 fan_out) {
+        auto start = tools::time::time_now();
+        {
+            tools::thread::pool pool(threads, mode);
+            for (u64 i = 0; i < spawners; ++i) {
+                pool.insert([&pool, fan_out] {
+                    for (u64 j = 0; j < fan_out; ++j) {
+                        pool.insert(tiny_task);
+                    }
+                });
+            }
+            pool.wait();
+        }
+        tools::time::s elapsed = tools::time::time_now() - start;
+        return tools::bench::ops_per_second(spawners * fan_out, elapsed);
+    }
+
+    std::vector<size_t> thread_counts() {
+        size_t max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        std::vector<size_t> counts;
+        for (size_t t = 1; t < max_threads; t *= 2) {
+            counts.push_back(t);
+        }
+        counts.push_back(max_threads);
+        return counts;
+    }
+}
+
+// 共享队列与工作窃取在 1..N 线程下的吞吐量对比
+TOOLS_BENCH(thread_pool_scaling) {
+    constexpr u64 spawners = 2000;
+    constexpr u64 fan_out = 1000;
+
+    for (size_t threads : thread_counts()) {
+        f64 shared = run_fan_out(threads, tools::thread::schedule_mode::shared_queue, spawners, fan_out);
+        f64 stealing = run_fan_out(threads, tools::thread::schedule_mode::work_stealing, spawners, fan_out);
+        tools::bench::metric("shared_queue/" + std::to_string(threads) + "_threads", shared, "ops/s");
+        tools::bench::metric("work_stealing/" + std::to_string(threads) + "_threads", stealing, "ops/s");
+        std::cout << "threads " << threads
+            << "  shared_queue " << static_cast<u64>(shared) << " ops/s"
+            << "  work_stealing " << static_cast<u64>(stealing) << " ops/s" << std::endl;
+    }
+}
+
+// 线程空闲（已休眠）时从提交到开始执行的延迟
+TOOLS_BENCH(thread_pool_wakeup_latency) {
+    constexpr u64 samples = 2000;
+
+    for (u32 spin_budget : { 0u, 100u, 10000u }) {
+        tools::thread::pool_options options;
+        options.spin_budget = spin_budget;
+        tools::thread::pool pool(options);
+
+        std::vector<f64> latency;
+        latency.reserve(samples);
+        for (u64 i = 0; i < samples; ++i) {
+            // 留出时间让工作线程进入休眠
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            auto submit_time = tools::time::time_now();
+            auto result = pool.submit([submit_time] {
+                return tools::time::us(tools::time::time_now() - submit_time).count();
+            });
+            latency.push_back(result.get());
+        }
+
+        tools::bench::record("spin_budget_" + std::to_string(spin_budget), std::move(latency), "us");
+    }
+}
+
+// 空闲线程池的 CPU 占用
+TOOLS_BENCH(thread_pool_idle_cpu) {
+    tools::thread::pool pool;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::clock_t cpu_start = std::clock();
+    auto wall_start = tools::time::time_now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    tools::time::s wall = tools::time::time_now() - wall_start;
+    f64 cpu = static_cast<f64>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    tools::bench::metric("idle_cpu", cpu / wall.count() * 100, "%");
+    std::cout << "threads " << pool.thread_count()
+        << "  idle cpu " << cpu / wall.count() * 100 << " %" << std::endl;
+}
+
+namespace {
+    // 模拟旧的提交路径：shared_ptr<std::function> + 外层 std::function
+    template<typename F>
+    std::function<void()> legacy_wrap(F f) {
+        auto task = std::make_shared<std::function<void()>>([=] { std::invoke(f); });
+        return [task] { (*task)(); };
+    }
+
+    template<typename Queue, typename Wrap>
+    void run_queue_path(const char* name, u64 ops, Wrap wrap) {
+        Queue queue;
+        u64 sum = 0;
+        u64 a = 1, b = 2, c = 3;
+
+        tools::bench::allocation_scope allocations;
+        auto start = tools::time::time_now();
+        for (u64 i = 0; i < ops; ++i) {
+            // 典型的小任务：捕获若干指针和整数
+            queue.push(wrap([&sum, &a, &b, &c, i] { sum += a + b + c + i; }));
+            (*queue.pop())();
+        }
+        tools::time::s elapsed = tools::time::time_now() - start;
+
+        std::string label = name;
+        label.erase(label.find_last_not_of(' ') + 1);
+        tools::bench::metric(label, tools::bench::ops_per_second(ops, elapsed), "ops/s");
+        std::cout << name
+            << "  " << static_cast<u64>(tools::bench::ops_per_second(ops, elapsed)) << " ops/s"
+            << "  " << static_cast<f64>(allocations.count()) / ops << " allocs/task"
+            << "  (checksum " << sum << ")" << std::endl;
+    }
+}
+
+// 任务包装与入队出队路径：旧路径与内联任务类型的分配次数和吞吐量
+TOOLS_BENCH(thread_task_allocations) {
+    constexpr u64 ops = 1000000;
+
+    run_queue_path<tools::thread::data::queue<std::function<void()>>>(
+        "legacy shared_ptr<function>", ops,
+        [](auto f) { return legacy_wrap(f); });
+    run_queue_path<tools::thread::data::queue<tools::thread::task>>(
+        "inline task               ", ops,
+        [](auto f) { return tools::thread::task(f); });
+
+    // 通过线程池提交的总分配次数
+    tools::thread::pool pool(1);
+    std::atomic<u64> done{ 0 };
+    tools::bench::allocation_scope allocations;
+    auto start = tools::time::time_now();
+    for (u64 i = 0; i < ops; ++i) {
+        pool.insert([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+    }
+    pool.wait();
+    tools::time::s elapsed = tools::time::time_now() - start;
+    tools::bench::metric("pool.insert", tools::bench::ops_per_second(ops, elapsed), "ops/s");
+    std::cout << "pool.insert               "
+        << "  " << static_cast<u64>(tools::bench::ops_per_second(ops, elapsed)) << " ops/s"
+        << "  " << static_cast<f64>(allocations.count()) / ops << " allocs/task" << std::endl;
+
+    // 工作窃取模式下工作线程提交到本地队列的分配次数（节点池预热后应为 0）
+    tools::thread::pool stealing(1, tools::thread::schedule_mode::work_stealing);
+    auto spawn = [&](u64 count) {
+        done.store(0, std::memory_order_relaxed);
+        stealing.insert([&stealing, &done, count] {
+            for (u64 i = 0; i < count; ++i) {
+                stealing.insert([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+        // wait() 会停止线程池，这里按计数等待
+        while (done.load(std::memory_order_relaxed) < count) {
+            std::this_thread::yield();
+        }
+    };
+    spawn(ops);
+    tools::bench::allocation_scope local_allocations;
+    start = tools::time::time_now();
+    spawn(ops);
+    elapsed = tools::time::time_now() - start;
+    tools::bench::metric("pool.insert local", tools::bench::ops_per_second(ops, elapsed), "ops/s");
+    std::cout << "pool.insert (local deque) "
+        << "  " << static_cast<u64>(tools::bench::ops_per_second(ops, elapsed)) << " ops/s"
+        << "  " << static_cast<f64>(local_allocations.count()) / ops << " allocs/task" << std::endl;
+}
+
+namespace {
+    // 递归任务组：每层在组内提交两个子问题并等待，工作线程内嵌套等待
+    u64 group_fib(tools::thread::pool& pool, u64 n) {
+        if (n < 16) {
+            return n < 2 ? n : group_fib(pool, n - 1) + group_fib(pool, n - 2);
+        }
+        u64 a = 0, b = 0;
+        tools::thread::task_group group(pool);
+        group.run([&] { a = group_fib(pool, n - 1); });
+        group.run([&] { b = group_fib(pool, n - 2); });
+        group.wait();
+        return a + b;
+    }
+}
+
+// 任务组：嵌套等待不死锁，等待后线程池继续可用
+TOOLS_BENCH(thread_task_group) {
+    constexpr u64 n = 30;
+    constexpr u64 expected = 832040;
+    constexpr u64 rounds = 5;
+
+    for (size_t threads : thread_counts()) {
+        for (auto mode : { tools::thread::schedule_mode::shared_queue, tools::thread::schedule_mode::work_stealing }) {
+            // 门闩须比线程池活得更久（最后一次 count_down 可能仍在唤醒）
+            tools::thread::latch done(1000);
+            tools::thread::pool pool(threads, mode);
+            bool ok = true;
+            auto start = tools::time::time_now();
+            for (u64 i = 0; i < rounds; ++i) {
+                ok = ok && group_fib(pool, n) == expected;
+            }
+            tools::time::s elapsed = tools::time::time_now() - start;
+
+            // 等待一批外部提交的任务，与线程池中其他任务互不影响
+            for (u64 i = 0; i < 1000; ++i) pool.insert([&done] { done.count_down(); });
+            done.wait(pool);
+
+            tools::bench::metric(std::string(mode == tools::thread::schedule_mode::shared_queue ? "shared_queue/" : "work_stealing/")
+                + std::to_string(threads) + "_threads", elapsed.count() * 1e3 / rounds, "ms");
+            std::cout << "threads " << threads
+                << (mode == tools::thread::schedule_mode::shared_queue ? "  shared_queue " : "  work_stealing")
+                << "  fib(" << n << ") " << elapsed.count() * 1e3 / rounds << " ms"
+                << "  " << (ok ? "ok" : "MISMATCH")
+                << "  pending " << pool.task_count() << std::endl;
+        }
+    }
+}
+
+namespace {
+    // 阻塞唯一的工作线程，直到提交完成后再放行，使各通道同时积压
+    struct gate {
+        std::atomic<bool> open{ false };
+
+        void block(tools::thread::pool& pool) {
+            pool.insert_to(tools::thread::priority::high, [this] {
+                while (!open.load(std::memory_order_acquire)) std::this_thread::yield();
+            });
+        }
+
+        void release() {
+            open.store(true, std::memory_order_release);
+        }
+    };
+}
+
+// 优先级通道：三个通道同时积压时的执行比例、排队时间，以及截止时间优先的顺序
+TOOLS_BENCH(thread_pool_priority) {
+    constexpr u64 per_lane = 20000;
+    constexpr u64 window = 2100;
+    const char* names[] = { "high      ", "normal    ", "background" };
+
+    {
+        tools::thread::pool_options options;
+        options.thread_count = 1;
+        tools::thread::latch done(per_lane * 3);
+        tools::thread::pool pool(options);
+        gate g;
+        g.block(pool);
+
+        std::vector<u8> order;
+        order.reserve(per_lane * 3);
+        for (u64 i = 0; i < per_lane; ++i) {
+            for (u8 lane = 0; lane < 3; ++lane) {
+                pool.insert_to(static_cast<tools::thread::priority>(lane), [&order, &done, lane] {
+                    order.push_back(lane);
+                    done.count_down();
+                });
+            }
+        }
+        g.release();
+        done.wait();
+
+        // 积压期间前 window 个任务中各通道所占比例
+        u64 share[3] = { 0, 0, 0 };
+        for (u64 i = 0; i < window; ++i) ++share[order[i]];
+        for (u8 lane = 0; lane < 3; ++lane) {
+            auto s = pool.stats(static_cast<tools::thread::priority>(lane));
+            std::string label = names[lane];
+            label.erase(label.find_last_not_of(' ') + 1);
+            tools::bench::metric("share/" + label, static_cast<f64>(share[lane]) / window * 100, "%");
+            std::cout << names[lane]
+                << "  share " << static_cast<f64>(share[lane]) / window * 100 << " %"
+                << "  executed " << s.executed
+                << "  depth " << s.depth
+                << "  avg wait " << s.average_wait.count() << " us"
+                << "  p99 wait " << s.p99_wait.count() << " us"
+                << "  max wait " << s.max_wait.count() << " us" << std::endl;
+        }
+    }
+
+    {
+        tools::thread::pool_options options;
+        options.thread_count = 1;
+        options.deadline_ordering = true;
+        tools::thread::latch done(per_lane);
+        tools::thread::pool pool(options);
+        gate g;
+        g.block(pool);
+
+        std::vector<i64> executed;
+        executed.reserve(per_lane);
+        std::mt19937_64 random(7);
+        auto base = tools::time::time_now();
+        for (u64 i = 0; i < per_lane; ++i) {
+            i64 offset = static_cast<i64>(random() % 1000000);
+            pool.insert_before(base + std::chrono::microseconds(offset), tools::thread::priority::normal,
+                [&executed, &done, offset] {
+                    executed.push_back(offset);
+                    done.count_down();
+                });
+        }
+        g.release();
+        done.wait();
+
+        u64 inversions = 0;
+        for (size_t i = 1; i < executed.size(); ++i) {
+            if (executed[i] < executed[i - 1]) ++inversions;
+        }
+        tools::bench::metric("deadline_inversions", static_cast<f64>(inversions), "count");
+        std::cout << "deadline ordering  executed " << executed.size()
+            << "  inversions " << inversions << std::endl;
+    }
+}
+
+namespace {
+    // 在 timeout 内运行 body，超时说明等待方没有被唤醒：打印后终止进程（无法回收卡住的线程）
+    void expect_finishes(const char* name, tools::time::ms timeout, const std::function<void()>& body) {
+        std::atomic<bool> finished{ false };
+        std::thread runner([&] {
+            body();
+            finished.store(true, std::memory_order_release);
+        });
+        auto deadline = tools::time::time_now() + std::chrono::duration_cast<tools::time::time_point::duration>(timeout);
+        while (!finished.load(std::memory_order_acquire) && tools::time::time_now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!finished.load(std::memory_order_acquire)) {
+            std::cout << "  " << name << "  DEADLOCK" << std::endl;
+            std::abort();
+        }
+        runner.join();
+        std::cout << "  " << name << "  ok" << std::endl;
+    }
+}
+
+// 帮助式等待的唤醒：唯一的工作线程在任务中等待门闩或任务组，
+// 放行的任务在等待开始之后才提交，等待方必须醒来执行它
+TOOLS_BENCH(thread_help_wakeup) {
+    using namespace std::chrono_literals;
+    for (auto mode : { tools::thread::schedule_mode::shared_queue, tools::thread::schedule_mode::work_stealing }) {
+        std::string suffix = mode == tools::thread::schedule_mode::shared_queue ? "/shared_queue" : "/work_stealing";
+
+        expect_finishes(("latch" + suffix).c_str(), tools::time::ms(2000), [mode] {
+            tools::thread::latch released(1);
+            tools::thread::latch done(1);
+            tools::thread::pool pool(1, mode);
+            pool.insert([&] {
+                released.wait(pool);
+                done.count_down();
+            });
+            std::this_thread::sleep_for(100ms);
+            pool.insert([&] { released.count_down(); });
+            done.wait();
+        });
+
+        expect_finishes(("task_group" + suffix).c_str(), tools::time::ms(2000), [mode] {
+            tools::thread::latch released(1);
+            tools::thread::latch done(1);
+            tools::thread::pool pool(1, mode);
+            pool.insert([&] {
+                // 组内任务在等待中嵌套等待门闩，完成后组的等待方也须醒来
+                tools::thread::task_group group(pool);
+                group.run([&] { released.wait(pool); });
+                group.wait();
+                done.count_down();
+            });
+            std::this_thread::sleep_for(100ms);
+            pool.insert([&] { released.count_down(); });
+            done.wait();
+        });
+    }
+}
+
+// 停止后提交：future 以异常结束，共享状态只释放一次（在 ASan 下检查）
+TOOLS_BENCH(thread_submit_after_join) {
+    for (auto mode : { tools::thread::schedule_mode::shared_queue, tools::thread::schedule_mode::work_stealing }) {
+        tools::thread::pool pool(1, mode);
+        pool.join();
+        u64 rejected = 0;
+        for (int i = 0; i < 3; ++i) {
+            auto result = pool.submit([] { return 1; });
+            try {
+                result.get();
+            }
+            catch (const std::runtime_error&) {
+                ++rejected;
+            }
+        }
+        bool ok = rejected == 3;
+        std::cout << (mode == tools::thread::schedule_mode::shared_queue ? "  shared_queue " : "  work_stealing")
+            << "  rejected " << rejected << "/3  " << (ok ? "ok" : "FAILED") << std::endl;
+        if (!ok) {
+            std::abort();
+        }
+    }
+}
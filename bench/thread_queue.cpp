@@ -0,0 +1,249 @@
+#include "bench.hpp"
+#include "../tools/module/thread.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+    // producers 个生产者各写入 per_producer 个元素（每次 push 写入 batch 个），consumers 个消费者读完为止
+    template<typename Push, typename Pop>
+    f64 run_mpmc(u64 producers, u64 consumers, u64 per_producer, u64 batch, Push push, Pop pop) {
+        const u64 total = producers * per_producer;
+        std::atomic<u64> consumed{ 0 };
+        std::vector<std::thread> threads;
+
+        auto start = tools::time::time_now();
+        for (u64 p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                for (u64 i = 0; i < per_producer; i += batch) push(i);
+            });
+        }
+        for (u64 c = 0; c < consumers; ++c) {
+            threads.emplace_back([&] {
+                while (consumed.load(std::memory_order_relaxed) < total) {
+                    u64 n = pop();
+                    if (n) consumed.fetch_add(n, std::memory_order_relaxed);
+                    else std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        tools::time::s elapsed = tools::time::time_now() - start;
+        return tools::bench::ops_per_second(total, elapsed);
+    }
+}
+
+// 无界链表队列与有界环形队列（单个与批量）的吞吐量
+TOOLS_BENCH(thread_queue_mpmc) {
+    constexpr u64 per_producer = 500000;
+    std::vector<u64> sides{ 1 };
+    if (std::thread::hardware_concurrency() / 2 > 1) {
+        sides.push_back(std::thread::hardware_concurrency() / 2);
+    }
+
+    for (u64 side : sides) {
+        tools::thread::data::queue<u64> linked;
+        f64 linked_ops = run_mpmc(side, side, per_producer, 1,
+            [&](u64 v) { linked.push(v); },
+            [&]() -> u64 { return linked.pop() ? 1 : 0; });
+
+        tools::thread::data::bounded_queue<u64> ring(4096);
+        f64 ring_ops = run_mpmc(side, side, per_producer, 1,
+            [&](u64 v) { ring.push(v); },
+            [&]() -> u64 { return ring.try_pop() ? 1 : 0; });
+
+        tools::thread::data::bounded_queue<u64> batch_ring(4096);
+        f64 batch_ops = run_mpmc(side, side, per_producer, 16,
+            [&](u64 v) {
+                u64 items[16];
+                std::fill(std::begin(items), std::end(items), v);
+                u64 done = 0;
+                while (done < 16) {
+                    u64 n = batch_ring.push_n(items + done, 16 - done);
+                    if (n == 0) std::this_thread::yield();
+                    done += n;
+                }
+            },
+            [&]() -> u64 {
+                u64 out[16];
+                return batch_ring.pop_n(out, 16);
+            });
+
+        std::string sides = std::to_string(side) + "p" + std::to_string(side) + "c";
+        tools::bench::metric("linked_list/" + sides, linked_ops, "ops/s");
+        tools::bench::metric("bounded_ring/" + sides, ring_ops, "ops/s");
+        tools::bench::metric("bounded_ring_x16/" + sides, batch_ops, "ops/s");
+        std::cout << side << "P/" << side << "C"
+            << "  linked_list " << static_cast<u64>(linked_ops) << " ops/s"
+            << "  bounded_ring " << static_cast<u64>(ring_ops) << " ops/s"
+            << "  bounded_ring x16 " << static_cast<u64>(batch_ops) << " ops/s" << std::endl;
+    }
+}
+
+// 线程池使用不同共享队列存储时的吞吐量
+TOOLS_BENCH(thread_pool_backend) {
+    constexpr u64 ops = 1000000;
+
+    for (auto backend : { tools::thread::queue_backend::linked_list, tools::thread::queue_backend::bounded_ring }) {
+        tools::thread::pool_options options;
+        options.backend = backend;
+        std::atomic<u64> done{ 0 };
+
+        auto start = tools::time::time_now();
+        {
+            tools::thread::pool pool(options);
+            for (u64 i = 0; i < ops; ++i) {
+                pool.insert([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+            pool.wait();
+        }
+        tools::time::s elapsed = tools::time::time_now() - start;
+
+        tools::bench::metric(backend == tools::thread::queue_backend::linked_list ? "linked_list" : "bounded_ring",
+            tools::bench::ops_per_second(ops, elapsed), "ops/s");
+        std::cout << (backend == tools::thread::queue_backend::linked_list ? "linked_list " : "bounded_ring")
+            << "  " << static_cast<u64>(tools::bench::ops_per_second(ops, elapsed)) << " ops/s" << std::endl;
+    }
+}
+
+// 多生产者多消费者压力测试，校验数据完整性并统计回收情况
+// 配合 -DTOOLS_BOX_SANITIZE=thread / address 编译运行可检查内存安全
+TOOLS_BENCH(thread_queue_reclaim_stress) {
+    constexpr u64 per_producer = 200000;
+    const u64 side = std::max<u64>(2, std::thread::hardware_concurrency());
+
+    tools::thread::data::queue<u64> queue;
+    std::atomic<u64> consumed{ 0 };
+    std::atomic<u64> sum{ 0 };
+    std::vector<std::thread> threads;
+    auto before = tools::thread::reclaim::stats();
+
+    for (u64 p = 0; p < side; ++p) {
+        threads.emplace_back([&] {
+            for (u64 i = 1; i <= per_producer; ++i) queue.push(i);
+        });
+    }
+    for (u64 c = 0; c < side; ++c) {
+        threads.emplace_back([&] {
+            u64 local = 0;
+            while (consumed.load(std::memory_order_relaxed) < side * per_producer) {
+                if (auto value = queue.pop()) {
+                    local += *value;
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            sum.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    auto after = tools::thread::reclaim::stats();
+    const u64 expected = side * per_producer * (per_producer + 1) / 2;
+    std::cout << side << "P/" << side << "C"
+        << "  " << (sum.load() == expected ? "ok" : "MISMATCH")
+        << "  retired " << after.retired - before.retired
+        << "  freed " << after.freed - before.freed
+        << "  epoch " << after.epoch << std::endl;
+}
+
+// 节点池：稳定状态下 push/pop 的堆分配次数与节点池统计
+TOOLS_BENCH(thread_queue_node_pool) {
+    constexpr u64 ops = 2000000;
+    constexpr u64 window = 1024;
+
+    tools::thread::data::queue<u64> queue(window);
+    // 预热：填满线程缓存
+    for (u64 i = 0; i < window; ++i) queue.push(i);
+    for (u64 i = 0; i < window; ++i) queue.pop();
+
+    auto before = tools::thread::data::queue<u64>::pool_stats();
+    tools::bench::allocation_scope allocations;
+    auto start = tools::time::time_now();
+    for (u64 i = 0; i < ops; ++i) {
+        queue.push(i);
+        if (i >= window) queue.pop();
+    }
+    tools::time::s elapsed = tools::time::time_now() - start;
+    u64 allocated = allocations.count();
+    auto after = tools::thread::data::queue<u64>::pool_stats();
+
+    tools::bench::metric("single_thread", tools::bench::ops_per_second(ops, elapsed), "ops/s");
+    std::cout << "single thread"
+        << "  " << static_cast<u64>(tools::bench::ops_per_second(ops, elapsed)) << " ops/s"
+        << "  " << static_cast<f64>(allocated) / ops << " allocs/op"
+        << "  chunks " << after.heap_allocations - before.heap_allocations
+        << "  nodes " << after.total_nodes
+        << "  batches released/acquired "
+        << after.batches_released - before.batches_released << "/"
+        << after.batches_acquired - before.batches_acquired << std::endl;
+
+    // 多生产者多消费者：节点在线程间流转
+    const u64 side = std::max<u64>(2, std::thread::hardware_concurrency() / 2);
+    before = tools::thread::data::queue<u64>::pool_stats();
+    f64 mpmc_ops = run_mpmc(side, side, ops / side, 1,
+        [&](u64 v) { queue.push(v); },
+        [&]() -> u64 { return queue.pop() ? 1 : 0; });
+    after = tools::thread::data::queue<u64>::pool_stats();
+
+    tools::bench::metric("mpmc", mpmc_ops, "ops/s");
+    std::cout << side << "P/" << side << "C"
+        << "  " << static_cast<u64>(mpmc_ops) << " ops/s"
+        << "  chunks " << after.heap_allocations - before.heap_allocations
+        << "  nodes " << after.total_nodes
+        << "  batches released/acquired "
+        << after.batches_released - before.batches_released << "/"
+        << after.batches_acquired - before.batches_acquired << std::endl;
+}
+
+// 单生产者单消费者：spsc_queue（单个与批量）与多生产者多消费者队列在相同流量下的对比
+TOOLS_BENCH(thread_queue_spsc) {
+    constexpr u64 items = 2000000;
+    constexpr u64 capacity = 4096;
+
+    tools::thread::data::spsc_queue<u64> spsc(capacity);
+    f64 spsc_ops = run_mpmc(1, 1, items, 1,
+        [&](u64 v) { while (!spsc.try_push(v)) std::this_thread::yield(); },
+        [&]() -> u64 { return spsc.try_pop() ? 1 : 0; });
+
+    tools::thread::data::spsc_queue<u64> batch_spsc(capacity);
+    f64 batch_ops = run_mpmc(1, 1, items, 16,
+        [&](u64 v) {
+            u64 values[16];
+            std::fill(std::begin(values), std::end(values), v);
+            u64 done = 0;
+            while (done < 16) {
+                u64 n = batch_spsc.push_n(values + done, 16 - done);
+                if (n == 0) std::this_thread::yield();
+                done += n;
+            }
+        },
+        [&]() -> u64 {
+            u64 out[16];
+            return batch_spsc.pop_n(out, 16);
+        });
+
+    tools::thread::data::bounded_queue<u64> ring(capacity);
+    f64 ring_ops = run_mpmc(1, 1, items, 1,
+        [&](u64 v) { while (!ring.try_push(v)) std::this_thread::yield(); },
+        [&]() -> u64 { return ring.try_pop() ? 1 : 0; });
+
+    tools::thread::data::queue<u64> linked;
+    f64 linked_ops = run_mpmc(1, 1, items, 1,
+        [&](u64 v) { linked.push(v); },
+        [&]() -> u64 { return linked.pop() ? 1 : 0; });
+
+    tools::bench::metric("spsc", spsc_ops, "ops/s");
+    tools::bench::metric("spsc_x16", batch_ops, "ops/s");
+    tools::bench::metric("bounded_ring", ring_ops, "ops/s");
+    tools::bench::metric("linked_list", linked_ops, "ops/s");
+    std::cout << "1P/1C"
+        << "  spsc " << static_cast<u64>(spsc_ops) << " ops/s"
+        << "  spsc x16 " << static_cast<u64>(batch_ops) << " ops/s"
+        << "  bounded_ring " << static_cast<u64>(ring_ops) << " ops/s"
+        << "  linked_list " << static_cast<u64>(linked_ops) << " ops/s" << std::endl;
+}
@@ -0,0 +1,105 @@
+#include "bench.hpp"
+#include "../tools/module/thread.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// 一百万个定时器的添加与取消
+TOOLS_BENCH(thread_timer_arm_cancel) {
+    constexpr u64 n = 1000000;
+
+    tools::thread::pool pool(2);
+    tools::thread::timer_options options;
+    options.reserve = n;
+    tools::thread::timer_wheel wheel(&pool, options);
+
+    // 到期时间按对数均匀分布在 1 s 到 10 小时之间，覆盖高层轮且测试期间不会触发
+    std::mt19937_64 random(42);
+    std::vector<tools::time::ms> delays(n);
+    for (auto& d : delays) {
+        d = tools::time::ms(std::exp(std::uniform_real_distribution<f64>(std::log(1e3), std::log(3.6e7))(random)));
+    }
+    std::vector<tools::thread::timer_wheel::timer_id> ids(n);
+    std::atomic<u64> fired{ 0 };
+
+    u64 allocated = 0;
+    tools::time::s arm_time{ 0 };
+    {
+        tools::bench::allocation_scope allocations;
+        auto start = tools::time::time_now();
+        for (u64 i = 0; i < n; ++i) {
+            ids[i] = wheel.schedule_after(delays[i], [&fired] { fired.fetch_add(1, std::memory_order_relaxed); });
+        }
+        arm_time = tools::time::time_now() - start;
+        allocated = allocations.count();
+    }
+    u64 armed = wheel.size();
+
+    // 乱序取消
+    std::shuffle(ids.begin(), ids.end(), random);
+    u64 cancelled = 0;
+    auto start = tools::time::time_now();
+    for (auto id : ids) cancelled += wheel.cancel(id) ? 1 : 0;
+    tools::time::s cancel_time = tools::time::time_now() - start;
+
+    // 已触发的定时器取消失败，二者之和应为总数
+    bool ok = cancelled + fired.load() == n && wheel.size() == 0 && !wheel.cancel(ids[0]);
+    tools::bench::metric("arm", tools::time::ns(arm_time).count() / n, "ns/op");
+    tools::bench::metric("cancel", tools::time::ns(cancel_time).count() / n, "ns/op");
+    std::cout << "arm     " << static_cast<u64>(tools::bench::ops_per_second(n, arm_time)) << " ops/s"
+        << "  " << tools::time::ns(arm_time).count() / n << " ns/op"
+        << "  heap allocs " << allocated << "  armed " << armed << std::endl;
+    std::cout << "cancel  " << static_cast<u64>(tools::bench::ops_per_second(n, cancel_time)) << " ops/s"
+        << "  " << tools::time::ns(cancel_time).count() / n << " ns/op"
+        << "  cancelled " << cancelled << "  fired " << fired.load()
+        << "  " << (ok ? "ok" : "MISMATCH") << std::endl;
+}
+
+// 触发精度（含跨层降级）与周期任务
+TOOLS_BENCH(thread_timer_accuracy) {
+    constexpr u64 n = 2000;
+
+    tools::thread::pool pool(2);
+    tools::thread::timer_wheel wheel(&pool);
+
+    std::mt19937_64 random(7);
+    std::vector<tools::time::time_point> deadlines(n);
+    std::vector<tools::time::time_point> fired_at(n);
+    tools::thread::latch done(n);
+
+    auto now = tools::time::time_now();
+    for (u64 i = 0; i < n; ++i) {
+        // 1 ms 到 700 ms，超过 256 格的定时器要经过一次降级
+        deadlines[i] = now + std::chrono::microseconds(std::uniform_int_distribution<i64>(1000, 700000)(random));
+        wheel.schedule_at(deadlines[i], [&, i] {
+            fired_at[i] = tools::time::time_now();
+            done.count_down();
+        });
+    }
+
+    std::atomic<u64> ticks{ 0 };
+    auto periodic = wheel.schedule_every(tools::time::ms(10), [&ticks] { ticks.fetch_add(1, std::memory_order_relaxed); });
+
+    done.wait();
+    wheel.cancel(periodic);
+    u64 periodic_ticks = ticks.load();
+
+    u64 early = 0;
+    std::vector<f64> lateness(n);
+    for (u64 i = 0; i < n; ++i) {
+        if (fired_at[i] < deadlines[i]) ++early;
+        lateness[i] = tools::time::ms(fired_at[i] - deadlines[i]).count();
+    }
+    std::sort(lateness.begin(), lateness.end());
+    auto stats = wheel.stats();
+
+    tools::bench::metric("lateness_p50", lateness[n / 2], "ms");
+    tools::bench::metric("lateness_p99", lateness[n * 99 / 100], "ms");
+    tools::bench::metric("early", static_cast<f64>(early), "count");
+    std::cout << "lateness  p50 " << lateness[n / 2] << " ms  p99 " << lateness[n * 99 / 100]
+        << " ms  max " << lateness[n - 1] << " ms  early " << early
+        << "  cascaded " << stats.cascaded << std::endl;
+    std::cout << "periodic  10 ms over ~700 ms -> " << periodic_ticks << " runs" << std::endl;
+}
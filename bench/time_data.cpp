@@ -0,0 +1,110 @@
+#include "bench.hpp"
+#include "../tools/module/data/bit_flag.hpp"
+#include "../tools/module/net/base.hpp"
+#include "../tools/module/time.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 取时间点与时间格式化的耗时
+TOOLS_BENCH(time_clock) {
+    constexpr u64 ops = 1000000;
+    tools::time::time_point sink;
+    tools::bench::measure("time_now", ops, [&] {
+        for (u64 i = 0; i < ops; ++i) sink = tools::time::time_now();
+    });
+
+    constexpr u64 formats = 10000;
+    std::string text;
+    tools::bench::measure("format_time_point", formats, [&] {
+        for (u64 i = 0; i < formats; ++i) text = tools::time::format_time_point(sink, 3);
+    });
+    std::cout << "  " << text << std::endl;
+}
+
+// 延迟直方图：记录的开销、多线程记录、合并读取，以及分位数与精确值的误差
+TOOLS_BENCH(time_histogram) {
+    constexpr u64 ops = 10000000;
+    std::mt19937_64 random(11);
+    std::lognormal_distribution<f64> distribution(9.0, 1.5);
+    std::vector<u64> values(1 << 16);
+    for (auto& v : values) v = static_cast<u64>(distribution(random));
+
+    tools::time::latency_snapshot plain;
+    tools::bench::measure("snapshot_record", ops, [&] {
+        for (u64 i = 0; i < ops; ++i) plain.record(values[i & 0xffff]);
+    });
+
+    tools::time::latency_histogram shared;
+    tools::bench::measure("histogram_record", ops, [&] {
+        for (u64 i = 0; i < ops; ++i) shared.record(values[i & 0xffff]);
+    });
+
+    constexpr u64 threads = 4;
+    tools::bench::measure("histogram_record_4_threads", ops, [&] {
+        std::vector<std::thread> workers;
+        for (u64 t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (u64 i = t; i < ops; i += threads) shared.record(values[i & 0xffff]);
+            });
+        }
+        for (auto& w : workers) w.join();
+    });
+
+    tools::time::latency_snapshot merged;
+    tools::bench::measure("snapshot_merge", 1000, [&] {
+        for (u64 i = 0; i < 1000; ++i) merged = shared.snapshot();
+    });
+
+    tools::time::latency_snapshot timers;
+    tools::bench::measure("scoped_timer", ops / 10, [&] {
+        for (u64 i = 0; i < ops / 10; ++i) tools::time::scoped_timer<tools::time::latency_snapshot> t(timers);
+    });
+
+    // 与精确分位数比较
+    tools::time::latency_snapshot exact_source;
+    for (u64 v : values) exact_source.record(v);
+    std::vector<u64> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    f64 worst = 0;
+    for (f64 p : { 50.0, 90.0, 99.0, 99.9 }) {
+        u64 rank = static_cast<u64>(std::ceil(p / 100.0 * sorted.size()));
+        f64 exact = static_cast<f64>(sorted[rank - 1]);
+        f64 error = (exact_source.percentile(p).count() - exact) / exact;
+        worst = std::max(worst, std::abs(error));
+    }
+    tools::bench::metric("max_relative_error", worst * 100, "%");
+    std::cout << "  single thread " << plain.summary() << std::endl;
+    std::cout << "  shared " << merged.summary() << "  worst percentile error " << worst * 100 << " %" << std::endl;
+}
+
+// 位标志的读写与网络地址键的哈希
+TOOLS_BENCH(data_bit_flag) {
+    constexpr u64 ops = 10000000;
+    tools::data::bit_flag<64> flags;
+    tools::bench::measure("set", ops, [&] {
+        for (u64 i = 0; i < ops; ++i) flags.set(i & 511, (i >> 9) & 1);
+    });
+
+    u64 count = 0;
+    tools::bench::measure("get", ops, [&] {
+        for (u64 i = 0; i < ops; ++i) count += flags.get(i & 511);
+    });
+
+    tools::net::ip_address__ address{ "192.168.100.200", 8080 };
+    std::hash<tools::net::ip_address__> hasher;
+    u64 hashes = 0;
+    tools::bench::measure("ip_address_hash", ops / 10, [&] {
+        for (u64 i = 0; i < ops / 10; ++i) {
+            address.port_ = static_cast<u16>(i);
+            hashes += hasher(address);
+        }
+    });
+    std::cout << "  bits read " << count << "  hash sum " << hashes << std::endl;
+}
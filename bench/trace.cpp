@@ -0,0 +1,124 @@
+#include "bench.hpp"
+#include "../tools/module/file.hpp"
+#include "../tools/module/thread.hpp"
+#include "../tools/module/trace.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+    // 微小任务的线程池吞吐量
+    f64 pool_throughput(u64 ops) {
+        std::atomic<u64> done{ 0 };
+        tools::thread::pool pool(2);
+        auto start = tools::time::time_now();
+        for (u64 i = 0; i < ops; ++i) {
+            pool.insert([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+        }
+        pool.wait();
+        tools::time::s elapsed = tools::time::time_now() - start;
+        return tools::bench::ops_per_second(ops, elapsed);
+    }
+}
+
+// 记录一个作用域事件（开始加结束）的开销，停止记录时的开销，以及埋点对线程池吞吐量的影响
+TOOLS_BENCH(trace_overhead) {
+    constexpr u64 ops = 1000000;
+
+    tools::trace::stop();
+    tools::bench::measure("scope_stopped", ops, [&] {
+        for (u64 i = 0; i < ops; ++i) tools::trace::scope s("bench", "op");
+    });
+
+    tools::trace::start();
+    tools::bench::measure("scope_recording", ops, [&] {
+        for (u64 i = 0; i < ops; ++i) tools::trace::scope s("bench", "op", static_cast<i64>(i));
+    });
+    tools::bench::measure("counter_recording", ops, [&] {
+        for (u64 i = 0; i < ops; ++i) tools::trace::emit(tools::trace::phase::counter, "bench", "value", static_cast<i64>(i));
+    });
+    tools::trace::stop();
+    tools::trace::clear();
+
+#if TOOLS_TRACE_ENABLED
+    constexpr u64 tasks = 500000;
+    f64 stopped = pool_throughput(tasks);
+    tools::trace::start();
+    f64 recording = pool_throughput(tasks);
+    tools::trace::stop();
+    tools::trace::clear();
+    tools::bench::metric("pool_stopped", stopped, "ops/s");
+    tools::bench::metric("pool_recording", recording, "ops/s");
+    std::cout << "  pool  stopped " << static_cast<u64>(stopped) << " ops/s"
+        << "  recording " << static_cast<u64>(recording) << " ops/s" << std::endl;
+#else
+    f64 compiled_out = pool_throughput(500000);
+    tools::bench::metric("pool_compiled_out", compiled_out, "ops/s");
+    std::cout << "  pool  " << static_cast<u64>(compiled_out) << " ops/s"
+        << "  (instrumentation compiled out, configure with -DTOOLS_BOX_TRACE=ON)" << std::endl;
+#endif
+}
+
+// 记录过程中导出：多个线程持续写入各自的缓冲区，同时导出 JSON；最后导出一次线程池与文件读写的追踪
+TOOLS_BENCH(trace_export) {
+    tools::trace::set_buffer_capacity(4096);
+    tools::trace::start();
+
+    std::atomic<bool> running{ true };
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 3; ++t) {
+        writers.emplace_back([&running, t] {
+            tools::trace::set_thread_name("writer " + std::to_string(t));
+            i64 n = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                tools::trace::scope s("bench", "work", n);
+                tools::trace::emit(tools::trace::phase::counter, "bench", "progress", ++n);
+            }
+        });
+    }
+
+    u64 exports = 0;
+    u64 bytes = 0;
+    auto until = tools::time::time_now() + std::chrono::milliseconds(300);
+    while (tools::time::time_now() < until) {
+        std::ostringstream out;
+        tools::trace::write_chrome_json(out);
+        bytes += out.str().size();
+        ++exports;
+    }
+    running.store(false);
+    for (auto& w : writers) w.join();
+
+    auto s = tools::trace::stats();
+    std::cout << "  concurrent exports " << exports << "  avg " << bytes / std::max<u64>(1, exports) / 1024 << " KiB"
+        << "  recorded " << s.recorded << "  overwritten " << s.overwritten << std::endl;
+    tools::trace::clear();
+
+    // 线程池与文件读写的追踪（编译期开关关闭时只有本线程的事件）
+    {
+        tools::thread::pool pool(2);
+        tools::file::file_task_pool files(&pool);
+        auto path = std::filesystem::temp_directory_path() / "tools_box_trace.bin";
+        std::vector<tools::file::byte> data(48 * tools::size::mi, 'x');
+        std::vector<tools::file::byte> in;
+        tools::trace::scope s("bench", "file round trip");
+        files.add_write(path, data);
+        files.wait();
+        files.add_read(path, in);
+        files.wait();
+        for (int i = 0; i < 1000; ++i) pool.insert([] {});
+        pool.wait();
+        std::filesystem::remove(path);
+    }
+    tools::trace::stop();
+
+    auto trace_path = std::filesystem::temp_directory_path() / "tools_box_trace.json";
+    bool ok = tools::trace::dump(trace_path.string());
+    std::cout << "  trace " << (ok ? "written to " : "failed: ") << trace_path.string()
+        << "  (" << (ok ? std::filesystem::file_size(trace_path) / 1024 : 0) << " KiB, open in ui.perfetto.dev)" << std::endl;
+    tools::trace::clear();
+    tools::trace::set_buffer_capacity(1 << 15);
+}
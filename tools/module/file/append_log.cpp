@@ -0,0 +1,362 @@
+#include "append_log.hpp"
+
+#include <algorithm>
+
+namespace tools::file {
+    namespace {
+        // 进程内共享的时间轮，只用于按时间的组提交
+        tools::thread::timer_wheel& sync_timer() {
+            static tools::thread::timer_wheel wheel;
+            return wheel;
+        }
+    }
+
+    // 连续的一段等待写入的数据
+    struct append_run {
+        u64 offset = 0;
+        u64 begin = 0;
+        u64 size = 0;
+    };
+
+    // 等待完成通知的追加
+    struct append_waiter {
+        u64 size = 0;
+        file_callback on_complete;
+    };
+
+    // 写入任务、定时器与 append_log 共同持有的状态
+    struct append_log::state : std::enable_shared_from_this<append_log::state> {
+        file_handle_ptr handle;
+        tools::thread::pool* workers = nullptr;
+        append_log_options options;
+
+        mutable std::mutex mutex;
+        // 写入任务结束、等待的数据减少时通知
+        std::condition_variable changed;
+
+        // 下一次追加的偏移量
+        u64 tail = 0;
+        // 等待写入的数据：buffer 中按 runs 分成偏移量连续的几段（reserve 会打断连续）
+        std::vector<byte> buffer;
+        std::vector<append_run> runs;
+        std::vector<append_waiter> waiters;
+        // 已交给写入任务的追加序号与已写完的序号
+        u64 queued = 0;
+        u64 written = 0;
+        // 写入任务是否在运行，进行中的写入与同步任务数
+        bool writing = false;
+        u64 tasks = 0;
+        bool closing = false;
+
+        // 未同步的字节数、上次同步的时间、定时器是否已设置
+        u64 unsynced = 0;
+        tools::time::time_point last_sync = tools::time::time_now();
+        bool timer_armed = false;
+
+        std::error_code error;
+        append_log_stats counters;
+
+        // 调用方持有 mutex：启动写入任务（线程池拒绝时在当前线程写入）
+        void start_writer(std::unique_lock<std::mutex>& lock);
+        // 写入任务：取出所有等待的数据写入，直到没有新的追加
+        void write_loop();
+        // 同步到存储设备并记录结果
+        std::error_code do_sync();
+        // 调用方持有 mutex：有未同步的数据且未设置定时器时设置
+        void arm_timer();
+        // 定时器到期
+        void on_timer();
+        // 调用方持有 mutex：一个写入或同步任务结束
+        void task_done();
+
+        // 等待 ready 成立，期间帮线程池执行任务：在同一线程池的工作线程上等待时，写入任务也能执行
+        template<typename P>
+        void wait_until(std::unique_lock<std::mutex>& lock, P ready) {
+            while (!ready()) {
+                lock.unlock();
+                bool ran = workers->try_run_one();
+                lock.lock();
+                if (!ran and !ready()) {
+                    changed.wait_for(lock, std::chrono::milliseconds(1));
+                }
+            }
+        }
+    };
+
+    void append_log::state::start_writer(std::unique_lock<std::mutex>& lock) {
+        writing = true;
+        ++tasks;
+        auto keep = shared_from_this();
+        lock.unlock();
+        bool accepted = false;
+        try {
+            accepted = workers->insert([keep] { keep->write_loop(); });
+        }
+        catch (...) {
+
+        }
+        if (!accepted) {
+            write_loop();
+        }
+        lock.lock();
+    }
+
+    void append_log::state::write_loop() {
+        std::vector<byte> batch;
+        std::vector<append_run> batch_runs;
+        std::vector<append_waiter> batch_waiters;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!runs.empty()) {
+            // 取出当前所有等待的数据，写入期间新的追加进入下一批
+            batch.swap(buffer);
+            batch_runs.swap(runs);
+            batch_waiters.swap(waiters);
+            u64 batch_end = queued;
+            changed.notify_all();
+            lock.unlock();
+
+            std::error_code ec;
+            u64 bytes = 0;
+            u64 calls = 0;
+            {
+                TOOLS_TRACE_SCOPE_ARG("file", "append_batch", batch.size());
+                for (auto& run : batch_runs) {
+                    std::error_code run_ec;
+                    bytes += handle->write_at(batch.data() + run.begin, run.size, run.offset, run_ec);
+                    ++calls;
+                    if (run_ec and !ec) ec = run_ec;
+                }
+            }
+
+            lock.lock();
+            counters.writes += calls;
+            unsynced += bytes;
+            if (ec and !error) error = ec;
+            // 按字节数或时间达到阈值时在本线程同步，否则交给定时器
+            bool sync_now = false;
+            if (options.sync.enabled()) {
+                sync_now = (options.sync.bytes and unsynced >= options.sync.bytes)
+                    or (options.sync.interval.count() > 0
+                        and tools::time::time_now() - last_sync >= options.sync.interval);
+                if (!sync_now) arm_timer();
+            }
+            lock.unlock();
+
+            if (sync_now) {
+                std::error_code sync_ec = do_sync();
+                if (sync_ec and !ec) ec = sync_ec;
+            }
+
+            // 回调在锁外调用
+            for (auto& waiter : batch_waiters) {
+                if (!waiter.on_complete) continue;
+                file_result result;
+                result.bytes = ec ? 0 : waiter.size;
+                result.error = ec;
+                try {
+                    waiter.on_complete(result);
+                }
+                catch (...) {
+
+                }
+            }
+            batch.clear();
+            batch_runs.clear();
+            batch_waiters.clear();
+
+            lock.lock();
+            written = batch_end;
+            changed.notify_all();
+        }
+        writing = false;
+        task_done();
+    }
+
+    std::error_code append_log::state::do_sync() {
+        std::unique_lock<std::mutex> lock(mutex);
+        // 只用于跟踪；在锁内取得，同步期间 unsynced 可能被写入任务修改
+        [[maybe_unused]] u64 pending = unsynced;
+        unsynced = 0;
+        last_sync = tools::time::time_now();
+        lock.unlock();
+
+        std::error_code ec;
+        {
+            TOOLS_TRACE_SCOPE_ARG("file", "append_sync", pending);
+            handle->sync(ec);
+        }
+
+        lock.lock();
+        ++counters.syncs;
+        if (ec and !error) error = ec;
+        return ec;
+    }
+
+    void append_log::state::arm_timer() {
+        if (timer_armed or closing or unsynced == 0 or options.sync.interval.count() <= 0) return;
+        timer_armed = true;
+        std::weak_ptr<state> weak = shared_from_this();
+        try {
+            auto deadline = last_sync + std::chrono::duration_cast<tools::time::time_point::duration>(options.sync.interval);
+            sync_timer().schedule_at(deadline, [weak] {
+                if (auto keep = weak.lock()) keep->on_timer();
+            });
+        }
+        catch (...) {
+            timer_armed = false;
+        }
+    }
+
+    void append_log::state::on_timer() {
+        std::unique_lock<std::mutex> lock(mutex);
+        timer_armed = false;
+        // 写入任务会自行检查是否需要同步；关闭时由析构函数同步
+        if (closing or writing or unsynced == 0) return;
+        ++tasks;
+        auto keep = shared_from_this();
+        lock.unlock();
+        // 同步可能耗时数毫秒，不在定时线程上执行
+        bool accepted = false;
+        try {
+            accepted = workers->insert([keep] {
+                keep->do_sync();
+                std::unique_lock<std::mutex> lock(keep->mutex);
+                keep->task_done();
+            });
+        }
+        catch (...) {
+
+        }
+        lock.lock();
+        if (!accepted) {
+            task_done();
+        }
+    }
+
+    void append_log::state::task_done() {
+        --tasks;
+        changed.notify_all();
+    }
+
+    append_log::append_log(const fs::path& path, const append_log_options& options)
+        : append_log([&] {
+        std::error_code ec;
+        file_handle_ptr file = file_handle::open(path, access::read_write, ec);
+        if (!file) {
+            throw std::system_error(ec, "Failed to open append log: " + path.string());
+        }
+        return file;
+            }(), options) {
+    }
+
+    append_log::append_log(file_handle_ptr file, const append_log_options& options)
+        : handle(std::move(file)) {
+        if (!handle or !handle->writable()) {
+            throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor), "Append log needs a writable file");
+        }
+        std::error_code ec;
+        u64 end = handle->size(ec);
+        if (ec) {
+            throw std::system_error(ec, "Failed to get append log size");
+        }
+
+        self = std::make_shared<state>();
+        self->handle = handle;
+        self->options = options;
+        self->tail = end;
+        self->workers = options.thread_pool;
+        if (!self->workers) {
+            owned_pool = std::make_unique<tools::thread::pool>(1);
+            self->workers = owned_pool.get();
+        }
+    }
+
+    append_log::~append_log() {
+        flush();
+        std::unique_lock<std::mutex> lock(self->mutex);
+        self->closing = true;
+        // 等待定时器提交的同步任务结束，之后不再使用线程池
+        self->wait_until(lock, [&] { return self->tasks == 0; });
+        bool pending = self->unsynced != 0 and self->options.sync.enabled();
+        lock.unlock();
+        if (pending) {
+            self->do_sync();
+        }
+        owned_pool.reset();
+    }
+
+    u64 append_log::append(const byte* data, u64 size, file_callback on_complete) {
+        std::unique_lock<std::mutex> lock(self->mutex);
+        // 写入跟不上时限制等待写入的数据量
+        if (self->buffer.size() + size > self->options.max_pending and !self->buffer.empty()) {
+            ++self->counters.stalls;
+            self->wait_until(lock, [&] {
+                return self->buffer.empty() or self->buffer.size() + size <= self->options.max_pending;
+            });
+        }
+
+        // 先预留空间，之后的修改不会抛出异常
+        self->runs.reserve(self->runs.size() + 1);
+        if (on_complete) {
+            self->waiters.reserve(self->waiters.size() + 1);
+        }
+        u64 offset = self->tail;
+        u64 begin = self->buffer.size();
+        self->buffer.insert(self->buffer.end(), data, data + size);
+        // 与上一段连续时合并，一批只需一次写入
+        if (!self->runs.empty() and self->runs.back().offset + self->runs.back().size == offset) {
+            self->runs.back().size += size;
+        }
+        else {
+            self->runs.push_back(append_run{ offset, begin, size });
+        }
+        if (on_complete) {
+            self->waiters.push_back(append_waiter{ size, std::move(on_complete) });
+        }
+        self->tail += size;
+        ++self->queued;
+        ++self->counters.appends;
+        self->counters.bytes += size;
+
+        if (!self->writing) {
+            self->start_writer(lock);
+        }
+        return offset;
+    }
+
+    u64 append_log::reserve(u64 size) {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        u64 offset = self->tail;
+        self->tail += size;
+        return offset;
+    }
+
+    std::error_code append_log::flush() {
+        std::unique_lock<std::mutex> lock(self->mutex);
+        u64 target = self->queued;
+        self->wait_until(lock, [&] { return self->written >= target; });
+        return self->error;
+    }
+
+    std::error_code append_log::sync() {
+        std::error_code ec = flush();
+        std::error_code sync_ec = self->do_sync();
+        return ec ? ec : sync_ec;
+    }
+
+    u64 append_log::size() const {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        return self->tail;
+    }
+
+    bool append_log::idle() const {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        return self->written == self->queued and self->tasks == 0;
+    }
+
+    append_log_stats append_log::stats() const {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        return self->counters;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include "../thread.hpp"
+
+#include "handle_cache.hpp"
+#include "result.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+namespace tools::file {
+    // 组提交策略：写入后累计字节数或距上次同步的时间达到阈值时同步到存储设备，都为 0 时不主动同步
+    struct sync_policy {
+        // 累计写入多少字节后同步
+        u64 bytes = 0;
+        // 有未同步的数据时，距上次同步最多多久（由定时器保证，没有新的追加也会同步）
+        tools::time::ms interval{ 0 };
+
+        bool enabled() const noexcept {
+            return bytes != 0 or interval.count() > 0;
+        }
+    };
+
+    // 追加日志配置
+    struct append_log_options {
+        // 执行写入的线程池，为空时使用自身的单线程线程池
+        tools::thread::pool* thread_pool = nullptr;
+        // 组提交策略
+        sync_policy sync;
+        // 等待写入的数据超过该字节数时，追加阻塞到写入跟上为止
+        u64 max_pending = 64 * 1024 * 1024;
+    };
+
+    // 追加日志统计信息
+    struct append_log_stats {
+        // 追加次数与字节数（不含 reserve）
+        u64 appends = 0;
+        u64 bytes = 0;
+        // 写入的系统调用次数（每批连续的数据一次）
+        u64 writes = 0;
+        // 同步次数
+        u64 syncs = 0;
+        // 因等待写入的数据过多而阻塞的追加次数
+        u64 stalls = 0;
+    };
+
+    // 单个文件的追加日志：追加时在锁内分配偏移量并复制数据，立即返回
+    // 等待写入的追加在线程池中合并为一次写入；同一时刻只有一个写入任务，写入期间到达的追加进入下一批
+    // 偏移量从打开时的文件末尾开始，只对经过本对象的追加有效；其他进程同时追加时仍会互相覆盖
+    class append_log {
+    public:
+        // 打开（不存在时创建）文件；失败时抛出 std::system_error
+        explicit append_log(const fs::path& path, const append_log_options& options = append_log_options());
+        // 使用已打开的读写句柄
+        explicit append_log(file_handle_ptr file, const append_log_options& options = append_log_options());
+
+        // 写入所有追加；启用组提交时再同步一次
+        ~append_log();
+
+        append_log(const append_log&) = delete;
+        append_log& operator=(const append_log&) = delete;
+
+        // 追加 size 字节（复制），返回数据在文件中的偏移量
+        // on_complete 在所在批次写入后在写入线程上调用（该批次触发同步时在同步之后）
+        u64 append(const byte* data, u64 size, file_callback on_complete = nullptr);
+
+        u64 append(const std::vector<byte>& data, file_callback on_complete = nullptr) {
+            return append(data.data(), data.size(), std::move(on_complete));
+        }
+
+        // 只分配 size 字节的偏移量，由调用方自行按偏移量写入（用于不值得复制的大块数据）
+        u64 reserve(u64 size);
+
+        // 等待调用前的追加都已写入，返回第一个写入或同步错误
+        std::error_code flush();
+
+        // 写入调用前的追加并同步到存储设备
+        std::error_code sync();
+
+        // 下一次追加的偏移量
+        u64 size() const;
+
+        // 是否没有等待写入的追加
+        bool idle() const;
+
+        // 使用的文件句柄
+        const file_handle_ptr& file() const noexcept {
+            return handle;
+        }
+
+        append_log_stats stats() const;
+
+    private:
+        struct state;
+
+        file_handle_ptr handle;
+        std::unique_ptr<tools::thread::pool> owned_pool;
+        std::shared_ptr<state> self;
+    };
+}
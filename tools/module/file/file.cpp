@@ -1,15 +1,56 @@
 #include "file.hpp"
 #include <iostream>
 namespace tools::file {
-	file_task_pool::file_task_pool(tools::thread::pool* thread_pool,u64 block_size) noexcept
+    namespace {
+        // 不超过该长度的追加复制进追加日志合并写入，更长的只分配偏移量后按分块直接写入
+        constexpr u64 append_copy_limit = 1024 * 1024;
+    }
+
+	file_task_pool::file_task_pool(tools::thread::pool* thread_pool,u64 block_size, handle_cache* handles) noexcept
+        : file_task_pool(_make_options_(thread_pool, block_size, handles))
+	{
+	}
+
+    file_pool_options file_task_pool::_make_options_(tools::thread::pool* thread_pool, u64 block_size, handle_cache* handles) noexcept
+    {
+        file_pool_options options;
+        options.thread_pool = thread_pool;
+        options.block_size = block_size;
+        options.handles = handles;
+        return options;
+    }
+
+	file_task_pool::file_task_pool(const file_pool_options& options) noexcept
 	{
-        if (thread_pool == nullptr)
+        tools::thread::pool* thread_pool = options.thread_pool;
+        u64 block_size = options.block_size;
+        handle_cache* handles = options.handles;
+
+        // 支持时使用 io_uring，失败则退回线程池
+        if (options.backend == io_backend::automatic and io_ring::supported()) {
+            try {
+                ring_ = std::make_unique<io_ring>(options.queue_depth);
+            }
+            catch (...) {
+
+            }
+        }
+
+        if (thread_pool == nullptr and !ring_)
         {
             thread_pool = new thread::pool();
             owner_pool_ = true;
         }
         thread_pool_ = thread_pool;
 
+        if (handles == nullptr)
+        {
+            owned_handles_ = std::make_unique<handle_cache>();
+            handles = owned_handles_.get();
+        }
+        handles_ = handles;
+        append_sync_ = options.append_sync;
+
 
         if (block_size <= tools::size::mi * 16) {
             block_size = tools::size::mi * 16;
@@ -20,6 +61,12 @@ namespace tools::file {
 	file_task_pool::~file_task_pool() noexcept
 	{
 		stop();
+        // 追加日志使用线程池，在释放线程池之前关闭
+        {
+            std::lock_guard<std::mutex> lock(logs_mutex_);
+            logs_.clear();
+            log_pool_.reset();
+        }
         if (owner_pool_) {
             delete thread_pool_;
         }
@@ -28,9 +75,54 @@ namespace tools::file {
 
 	u64 file_task_pool::get_task_count()const noexcept
 	{
-        return task_count_.load(std::memory_order_relaxed);
+        return task_count_.pending();
 	}
 
+    tools::thread::inflight_snapshot file_task_pool::snapshot() const noexcept
+    {
+        return task_count_.snapshot();
+    }
+
+    tools::time::latency_snapshot file_task_pool::write_latency() const noexcept
+    {
+        return write_latency_.snapshot();
+    }
+
+    tools::time::latency_snapshot file_task_pool::read_latency() const noexcept
+    {
+        return read_latency_.snapshot();
+    }
+
+    handle_cache& file_task_pool::handles() noexcept
+    {
+        return *handles_;
+    }
+
+    bool file_task_pool::uses_io_uring() const noexcept
+    {
+        return ring_ != nullptr;
+    }
+
+    io_ring_stats file_task_pool::ring_stats() const
+    {
+        return ring_ ? ring_->stats() : io_ring_stats{};
+    }
+
+    append_log_stats file_task_pool::append_stats() const
+    {
+        append_log_stats total;
+        std::lock_guard<std::mutex> lock(logs_mutex_);
+        for (auto& [path, log] : logs_) {
+            append_log_stats s = log->stats();
+            total.appends += s.appends;
+            total.bytes += s.bytes;
+            total.writes += s.writes;
+            total.syncs += s.syncs;
+            total.stalls += s.stalls;
+        }
+        return total;
+    }
+
 	void file_task_pool::stop()			noexcept
 	{
 		is_running_.store(false, std::memory_order_relaxed);
@@ -40,42 +132,295 @@ namespace tools::file {
 
 	void file_task_pool::wait()			const noexcept
 	{
-		while (task_count_.load(std::memory_order_relaxed) > 0) {
+		while (!task_count_.idle()) {
 			std::this_thread::sleep_for(std::chrono::milliseconds(1));
 		}
 		return;
 	}
 
+    file_task_pool::request_ptr file_task_pool::_make_request_(std::function<void()> on_complete, file_callback on_result)
+    {
+        if (!on_complete and !on_result) {
+            return nullptr;
+        }
+        auto request = std::make_shared<request_state>();
+        request->on_complete = std::move(on_complete);
+        request->on_result = std::move(on_result);
+        return request;
+    }
+
+    void file_task_pool::_record_(const request_ptr& request, u64 bytes, const std::error_code& ec) noexcept
+    {
+        if (!request) {
+            return;
+        }
+        if (bytes) {
+            request->bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        // 写入的 error 由 _finish_ 中 remaining 的 acq_rel 递减对最后一块可见
+        if (ec and !request->failed.exchange(true, std::memory_order_relaxed)) {
+            request->error = ec;
+        }
+    }
+
+    void file_task_pool::_finish_(const request_ptr& request, bool counted, tools::thread::pool* completions) noexcept
+    {
+        if (!request or request->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            if (counted) task_count_.end();
+            return;
+        }
+        // 交给线程池的回调持有计数，本对象在计数归零前不会被析构
+        if (completions) {
+            bool accepted = false;
+            try {
+                accepted = completions->insert([this, request, counted] {
+                    _notify_(request);
+                    if (counted) task_count_.end();
+                    });
+            }
+            catch (...) {
+
+            }
+            if (accepted) {
+                return;
+            }
+        }
+        _notify_(request);
+        if (counted) task_count_.end();
+    }
+
+    void file_task_pool::_notify_(const request_ptr& request) noexcept
+    {
+        try {
+            if (request->on_result) {
+                file_result result;
+                result.bytes = request->bytes.load(std::memory_order_relaxed);
+                result.error = request->error;
+                request->on_result(result);
+            }
+            else {
+                request->on_complete();
+            }
+        }
+        catch (...) {
+
+        }
+    }
+
+    template<typename F>
+    void file_task_pool::_submit_(const request_ptr& request, tools::time::latency_histogram& latency, F&& chunk)
+    {
+        task_count_.begin(); // 增加任务计数
+        TOOLS_TRACE_INSTANT("file", "submit_chunk", 0);
+        if (request) {
+            request->remaining.fetch_add(1, std::memory_order_relaxed);
+        }
+        // 添加任务，分块结束后通知请求
+        bool accepted = thread_pool_->insert([this, request, &latency, submitted = tools::time::time_now(),
+            chunk = std::forward<F>(chunk)]() mutable {
+            std::error_code ec;
+            u64 bytes = chunk(ec);
+            _record_(request, bytes, ec);
+            // 计数归零后本对象可能被析构，先记录延迟
+            latency.record_since(submitted);
+            _finish_(request, true);
+            });
+        if (!accepted) {
+            _record_(request, 0, std::make_error_code(std::errc::operation_canceled));
+            _finish_(request, true);
+        }
+    }
+
+    io_operation_ptr file_task_pool::_make_operation_(
+        const request_ptr& request,
+        tools::time::latency_histogram& latency,
+        io_operation::kind kind,
+        const file_handle_ptr& file,
+        byte* data,
+        u64 byte_size,
+        u64 skip_byte_size
+    ) {
+        auto op = std::make_unique<io_operation>();
+        op->op = kind;
+        op->file = file;
+        op->data = data;
+        op->size = byte_size;
+        op->offset = skip_byte_size;
+        // 在收割线程上调用，计数归零后本对象可能被析构，先记录延迟
+        // 有线程池时回调交给线程池，收割线程只处理完成（使用 io_uring 时线程池总是调用方提供的）
+        op->on_complete = [this, request, &latency, completions = thread_pool_,
+            submitted = tools::time::time_now()](io_operation& op) {
+            _record_(request, op.done, op.error);
+            latency.record_since(submitted);
+            _finish_(request, true, completions);
+            };
+
+        // 操作创建成功后才计数，之后必须提交给 io_uring
+        task_count_.begin();
+        TOOLS_TRACE_INSTANT("file", "submit_chunk", 1);
+        if (request) {
+            request->remaining.fetch_add(1, std::memory_order_relaxed);
+        }
+        return op;
+    }
+
     void file_task_pool::add_write(
 		fs::path path,
 		std::vector<byte>& data,
 		mode mode
     ) noexcept {
+        _add_write_(std::move(path), data, mode, nullptr);
+    }
+
+    void file_task_pool::add_read(
+        fs::path path,
+        std::vector<byte>& data
+    ) noexcept {
+        _add_read_(std::move(path), data, nullptr);
+    }
+
+    void file_task_pool::add_write(
+		fs::path path,
+		std::vector<byte>& data,
+		mode mode,
+        std::function<void()> on_complete
+    ) noexcept {
+        request_ptr request;
+        try {
+            request = _make_request_(std::move(on_complete), nullptr);
+        }
+        catch (...) {
+            return;
+        }
+        _add_write_(std::move(path), data, mode, request);
+    }
+
+    void file_task_pool::add_write_result(
+        fs::path path,
+        std::vector<byte>& data,
+        mode mode,
+        file_callback on_result
+    ) noexcept {
+        request_ptr request;
+        try {
+            request = _make_request_(nullptr, std::move(on_result));
+        }
+        catch (...) {
+            return;
+        }
+        _add_write_(std::move(path), data, mode, request);
+    }
+
+    void file_task_pool::add_read(
+        fs::path path,
+        std::vector<byte>& data,
+        std::function<void()> on_complete
+    ) noexcept {
+        request_ptr request;
+        try {
+            request = _make_request_(std::move(on_complete), nullptr);
+        }
+        catch (...) {
+            return;
+        }
+        _add_read_(std::move(path), data, request);
+    }
+
+    void file_task_pool::add_read_result(
+        fs::path path,
+        std::vector<byte>& data,
+        file_callback on_result
+    ) noexcept {
+        request_ptr request;
+        try {
+            request = _make_request_(nullptr, std::move(on_result));
+        }
+        catch (...) {
+            return;
+        }
+        _add_read_(std::move(path), data, request);
+    }
+
+    void file_task_pool::add_map(
+        fs::path path,
+        mapped_file& file,
+        map_hint hint,
+        std::function<void()> on_complete
+    ) noexcept {
+        request_ptr request;
+        try {
+            request = _make_request_(std::move(on_complete), nullptr);
+        }
+        catch (...) {
+            return;
+        }
+        _add_map_(std::move(path), file, hint, request);
+    }
+
+    void file_task_pool::add_map_result(
+        fs::path path,
+        mapped_file& file,
+        map_hint hint,
+        file_callback on_result
+    ) noexcept {
+        request_ptr request;
+        try {
+            request = _make_request_(nullptr, std::move(on_result));
+        }
+        catch (...) {
+            return;
+        }
+        _add_map_(std::move(path), file, hint, request);
+    }
+
+    void file_task_pool::_add_write_(
+        fs::path path,
+        std::vector<byte>& data,
+        mode mode,
+        const request_ptr& request
+    ) noexcept {
+
         if (
             // 检查是否运行
             !is_running_.load(std::memory_order_relaxed)
             // 检查线程池是否可用
-            or !thread_pool_
+            or (!thread_pool_ and !ring_)
             ) {
+            _record_(request, 0, std::make_error_code(std::errc::operation_canceled));
+            _finish_(request);
             return;
         }
 
+        // 使用 io_uring 时收集各分块，最后整批提交
+        std::vector<io_operation_ptr> batch;
         try {
+            // 打开文件（不存在时创建），各分块共用同一个句柄
+            std::error_code ec;
+            file_handle_ptr file = handles_->acquire(path, access::read_write, ec);
+            if (!file) {
+                throw std::system_error(ec, "Failed to open file for writing: " + path.string());
+            }
+
             u64 file_size = 0;
-            // 追加模式
+            // 追加模式：由追加日志分配偏移量
             if (mode == mode::addend) {
-                if (!fs::exists(path)) {
-                    std::ofstream file(path, std::ios::out | std::ios::binary);
-                    file.close();
+                std::shared_ptr<append_log> log = _log_(path, file);
+                if (data.size() <= append_copy_limit) {
+                    _append_(*log, data, request);
+                    _finish_(request);
+                    return;
                 }
-                file_size = fs::file_size(path);
+                file_size = log->reserve(data.size());
             }
 
-            // 清空文件（覆盖模式）
+            // 覆盖模式：直接把文件长度设为新数据的长度，各分块再覆盖写入
+            // 不先截断为 0：ext4 等文件系统在截断为 0 的文件关闭时会立即开始回写
             if (mode == mode::cover) {
-                std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
-                if (!file.is_open()) {
-                    throw std::ios::failure("Failed to open file for clearing: " + path.string());
+                // 追加日志记录的文件末尾不再有效
+                _drop_log_(path);
+                file->resize(data.size(), ec);
+                if (ec) {
+                    throw std::system_error(ec, "Failed to clear file: " + path.string());
                 }
             }
 
@@ -83,133 +428,268 @@ namespace tools::file {
             u64 data_size = data.size();
             u64 now_data = 0;
 
+            if (ring_) {
+                batch.reserve(data_size / block_size_ + 1);
+            }
+
             // 创建任务
             while (now_data < data_size) {
-                task_count_.fetch_add(1, std::memory_order_relaxed); // 增加任务计数
-                // 添加任务
-                thread_pool_->insert([this, path, now_data, &data, data_size, file_size]() {
-                    _write_(path,
-                        const_cast<byte*>(&(data)[now_data]),
-                        std::min(block_size_, (data_size - now_data)), 
-                        now_data + file_size);
-                    });
-                now_data += std::min(block_size_, (data_size - now_data));
+                u64 byte_size = std::min(block_size_, (data_size - now_data));
+                if (ring_) {
+                    batch.push_back(_make_operation_(request, write_latency_, io_operation::kind::write,
+                        file, &data[now_data], byte_size, now_data + file_size));
+                }
+                else {
+                    // 添加任务
+                    _submit_(request, write_latency_, [this, file, now_data, &data, byte_size, file_size](std::error_code& ec) {
+                        return _write_(*file,
+                            const_cast<byte*>(&(data)[now_data]),
+                            byte_size,
+                            now_data + file_size,
+                            ec);
+                        });
+                }
+                now_data += byte_size;
             }
         }
+        catch (const std::system_error& e) {
+            _record_(request, 0, e.code());
+        }
         catch (...) {
-
+            _record_(request, 0, std::make_error_code(std::errc::not_enough_memory));
         }
+        // 已创建的分块一次进入提交队列
+        if (!batch.empty()) {
+            ring_->submit(batch);
+        }
+        // 释放提交期间持有的计数
+        _finish_(request);
         return;
     }
 
-	void file_task_pool::add_read(
+    std::shared_ptr<append_log> file_task_pool::_log_(const fs::path& path, const file_handle_ptr& file)
+    {
+        std::lock_guard<std::mutex> lock(logs_mutex_);
+        auto& slot = logs_[path.string()];
+        if (slot and slot->file() == file) {
+            return slot;
+        }
+
+        // 日志数超过句柄预算时移除空闲的日志
+        if (logs_.size() > handles_->max_open()) {
+            for (auto it = logs_.begin(); it != logs_.end();) {
+                if (it->second and it->second != slot and it->second->idle()) {
+                    it = logs_.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+
+        // 使用 io_uring 时没有线程池，各文件的日志共用一个写入线程
+        if (!thread_pool_ and !log_pool_) {
+            log_pool_ = std::make_unique<tools::thread::pool>(1);
+        }
+        append_log_options options;
+        options.thread_pool = thread_pool_ ? thread_pool_ : log_pool_.get();
+        options.sync = append_sync_;
+        slot = std::make_shared<append_log>(file, options);
+        return slot;
+    }
+
+    void file_task_pool::_drop_log_(const fs::path& path)
+    {
+        std::shared_ptr<append_log> log;
+        {
+            std::lock_guard<std::mutex> lock(logs_mutex_);
+            if (logs_.empty()) {
+                return;
+            }
+            auto found = logs_.find(path.string());
+            if (found == logs_.end()) {
+                return;
+            }
+            log = std::move(found->second);
+            logs_.erase(found);
+        }
+        // 在锁外写入剩余的追加
+        log.reset();
+    }
+
+    void file_task_pool::_append_(append_log& log, const std::vector<byte>& data, const request_ptr& request)
+    {
+        task_count_.begin();
+        TOOLS_TRACE_INSTANT("file", "submit_chunk", 2);
+        if (request) {
+            request->remaining.fetch_add(1, std::memory_order_relaxed);
+        }
+        try {
+            // 在写入线程上调用，计数归零后本对象可能被析构，先记录延迟
+            log.append(data, [this, request, submitted = tools::time::time_now()](const file_result& result) {
+                _record_(request, result.bytes, result.error);
+                write_latency_.record_since(submitted);
+                _finish_(request, true);
+                });
+        }
+        catch (...) {
+            _finish_(request, true);
+            throw;
+        }
+    }
+
+	void file_task_pool::_add_read_(
 		fs::path path,
-		std::vector<byte>& data
+		std::vector<byte>& data,
+        const request_ptr& request
 	) noexcept
 	{
+
         if (
             // 检查是否运行
             !is_running_.load(std::memory_order_relaxed)
             // 检查线程池是否可用
-            or !thread_pool_
-            // 检查文件是否存在
-            or !fs::exists(path)
-            // 检查是否为文件
-            or !fs::is_regular_file(path)
+            or (!thread_pool_ and !ring_)
             ) {
             data.resize(0);
+            _record_(request, 0, std::make_error_code(std::errc::operation_canceled));
+            _finish_(request);
             return;
         }
 
-        // 获取文件大小并设置缓冲区
-        u64 file_size = fs::file_size(path);
-        data.resize(file_size);
-
+        // 使用 io_uring 时收集各分块，最后整批提交
+        std::vector<io_operation_ptr> batch;
+        try {
+            // 打开文件（不存在或不是普通文件时失败），各分块共用同一个句柄
+            std::error_code ec;
+            file_handle_ptr file = handles_->acquire(path, access::read, ec);
+            if (!file) {
+                data.resize(0);
+                _record_(request, 0, ec);
+                _finish_(request);
+                return;
+            }
 
+            // 获取文件大小并设置缓冲区
+            u64 file_size = file->size(ec);
+            if (ec) {
+                throw std::system_error(ec, "Failed to get file size: " + path.string());
+            }
+            data.resize(file_size);
 
-        try {
             // 计算块数
             u64 data_size = file_size;
             u64 now_data = 0;
 
+            if (ring_) {
+                batch.reserve(data_size / block_size_ + 1);
+            }
+
             // 创建任务
             while (now_data < data_size) {
-                task_count_.fetch_add(1, std::memory_order_relaxed); // 增加任务计数
-                // 添加任务
-                thread_pool_->insert([this, path, now_data, &data, data_size]() {
-                    _read_(path,
-                        const_cast<byte*>(&(data)[now_data]),
-                        std::min(block_size_, (data_size - now_data)),
-                        now_data);
-                    });
-                now_data += std::min(block_size_, (data_size - now_data));
+                u64 byte_size = std::min(block_size_, (data_size - now_data));
+                if (ring_) {
+                    batch.push_back(_make_operation_(request, read_latency_, io_operation::kind::read,
+                        file, &data[now_data], byte_size, now_data));
+                }
+                else {
+                    // 添加任务
+                    _submit_(request, read_latency_, [this, file, now_data, &data, byte_size](std::error_code& ec) {
+                        return _read_(*file,
+                            const_cast<byte*>(&(data)[now_data]),
+                            byte_size,
+                            now_data,
+                            ec);
+                        });
+                }
+                now_data += byte_size;
             }
         }
+        catch (const std::system_error& e) {
+            _record_(request, 0, e.code());
+        }
         catch (...) {
-
+            _record_(request, 0, std::make_error_code(std::errc::not_enough_memory));
         }
+        // 已创建的分块一次进入提交队列
+        if (!batch.empty()) {
+            ring_->submit(batch);
+        }
+        // 释放提交期间持有的计数
+        _finish_(request);
         return;
 	}
 
-    void file_task_pool::_write_(fs::path path, byte* data, u64 byte_size, u64 skip_byte_size) noexcept {
-        std::fstream file;
-
-        if (is_running_.load(std::memory_order_relaxed)) {
-            try {
-                // 打开文件（读写模式，不清空内容）
-                file.open(path, std::ios::in | std::ios::out | std::ios::binary);
-                if (!file.is_open()) {
-                    throw std::ios::failure("Failed to open file for writing: " + path.string());
-                }
+    void file_task_pool::_add_map_(
+        fs::path path,
+        mapped_file& file,
+        map_hint hint,
+        const request_ptr& request
+    ) noexcept {
+        // 检查是否运行
+        if (!is_running_.load(std::memory_order_relaxed)) {
+            file.close();
+            _record_(request, 0, std::make_error_code(std::errc::operation_canceled));
+            _finish_(request);
+            return;
+        }
 
-                // 设置偏移量并写入数据
-                file.seekp(skip_byte_size);
-                file.write(reinterpret_cast<char*>(data), byte_size);
+        // 映射本身不读取文件，在当前线程完成
+        std::error_code ec;
+        file = mapped_file::map(path, hint, ec);
+        if (ec) {
+            _record_(request, 0, ec);
+            _finish_(request);
+            return;
+        }
 
-                // 检查写入是否成功
-                if (!file) {
-                    throw std::ios::failure("Failed to write data to file: " + path.string());
+        try {
+            // 预读：各分块在线程池中并行缺页
+            if (hint == map_hint::willneed and thread_pool_) {
+                u64 data_size = file.size();
+                u64 now_data = 0;
+                while (now_data < data_size) {
+                    u64 byte_size = std::min(block_size_, (data_size - now_data));
+                    _submit_(request, read_latency_, [&file, now_data, byte_size](std::error_code&) {
+                        TOOLS_TRACE_SCOPE_ARG("file", "populate_chunk", byte_size);
+                        file.populate(now_data, byte_size);
+                        return byte_size;
+                        });
+                    now_data += byte_size;
                 }
-
-                file.close();
             }
-            catch (...) {
-
+            else {
+                _record_(request, file.size(), ec);
             }
         }
-
-        // 减少任务计数器
-        task_count_.fetch_sub(1, std::memory_order_relaxed);
+        catch (...) {
+            _record_(request, 0, std::make_error_code(std::errc::not_enough_memory));
+        }
+        // 释放提交期间持有的计数
+        _finish_(request);
+        return;
     }
 
-    void file_task_pool::_read_(fs::path path, byte* data, u64 byte_size, u64 skip_byte_size) noexcept {
-        std::fstream file;
-
-        if (is_running_.load(std::memory_order_relaxed)) {
-            try {
-                // 打开文件（读取模式）
-                file.open(path, std::ios::in | std::ios::binary);
-                if (!file.is_open()) {
-                    throw std::ios::failure("Failed to open file for reading: " + path.string());
-                }
-
-                // 设置偏移量并读取数据
-                file.seekg(skip_byte_size);
-                file.read(reinterpret_cast<char*>(data), byte_size);
+    u64 file_task_pool::_write_(const file_handle& file, byte* data, u64 byte_size, u64 skip_byte_size, std::error_code& ec) noexcept {
+        TOOLS_TRACE_SCOPE_ARG("file", "write_chunk", byte_size);
 
-                // 检查读取是否成功
-                if (!file) {
-                    throw std::ios::failure("Failed to read data from file: " + path.string());
-                }
+        // 停止后不再写入尚未开始的分块
+        if (!is_running_.load(std::memory_order_relaxed)) {
+            ec = std::make_error_code(std::errc::operation_canceled);
+            return 0;
+        }
+        // 按偏移量写入，不移动文件位置，各分块可并发写入同一个句柄
+        return file.write_at(data, byte_size, skip_byte_size, ec);
+    }
 
-                file.close();
-            }
-            catch (...) {
+    u64 file_task_pool::_read_(const file_handle& file, byte* data, u64 byte_size, u64 skip_byte_size, std::error_code& ec) noexcept {
+        TOOLS_TRACE_SCOPE_ARG("file", "read_chunk", byte_size);
 
-            }
+        if (!is_running_.load(std::memory_order_relaxed)) {
+            ec = std::make_error_code(std::errc::operation_canceled);
+            return 0;
         }
-
-        // 减少任务计数器
-        task_count_.fetch_sub(1, std::memory_order_relaxed);
+        // 按偏移量读取，不移动文件位置，各分块可并发读取同一个句柄
+        return file.read_at(data, byte_size, skip_byte_size, ec);
     }
 }
\ No newline at end of file
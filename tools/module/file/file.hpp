@@ -5,10 +5,32 @@
 
 #include "../thread.hpp"
 
+// 文件句柄缓存
+#include "handle_cache.hpp"
+
+// io_uring 异步读写
+#include "uring.hpp"
+
+// 内存映射文件
+#include "mapped_file.hpp"
+
+// 读写结果
+#include "result.hpp"
+
+// 追加日志
+#include "append_log.hpp"
+
 
 #include <filesystem>
 #include <fstream>
 #include <atomic>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <unordered_map>
 
 namespace tools::file {
     using byte = char;
@@ -21,26 +43,108 @@ namespace tools::file {
         addend,
     };
 
+    // 分块读写的执行方式
+    enum class io_backend {
+        // 支持 io_uring 时提交到 io_uring，否则在线程池中阻塞读写
+        automatic,
+        // 总是在线程池中阻塞读写
+        thread_pool,
+    };
+
+    // 文件任务池配置
+    struct file_pool_options {
+        // 线程池，为空时按需创建自身的线程池（使用 io_uring 时不需要）
+        tools::thread::pool* thread_pool = nullptr;
+        // 分块大小（不小于 16 MiB）
+        u64 block_size = tools::size::max<u64>();
+        // 文件句柄缓存，为空时使用自身的缓存（多个任务池可共用一个缓存）
+        handle_cache* handles = nullptr;
+        // 分块读写的执行方式
+        io_backend backend = io_backend::automatic;
+        // io_uring 同时进行的读写数上限（队列深度）
+        u32 queue_depth = 64;
+        // 追加模式写入的组提交策略
+        sync_policy append_sync;
+    };
+
     class file_task_pool {
     public:
         // 初始化
-        file_task_pool(tools::thread::pool* thread_pool = nullptr, u64 block_size = tools::size::max<u64>())  noexcept;
+        // handles：文件句柄缓存，为空时使用自身的缓存（多个任务池可共用一个缓存）
+        file_task_pool(tools::thread::pool* thread_pool = nullptr, u64 block_size = tools::size::max<u64>(),
+            handle_cache* handles = nullptr)  noexcept;
+        explicit file_task_pool(const file_pool_options& options)  noexcept;
         // 析构
         ~file_task_pool() noexcept;
         // 输出剩余任务数
         u64 get_task_count()    const noexcept;
+        // 累计提交、完成的分块数与剩余分块数
+        tools::thread::inflight_snapshot snapshot() const noexcept;
+        // 写入分块的延迟分布（从提交到写完，含线程池排队时间）
+        tools::time::latency_snapshot write_latency() const noexcept;
+        // 读取分块的延迟分布（从提交到读完，含线程池排队时间）
+        tools::time::latency_snapshot read_latency() const noexcept;
+        // 使用的文件句柄缓存
+        handle_cache& handles() noexcept;
+        // 是否使用 io_uring 读写
+        bool uses_io_uring()    const noexcept;
+        // io_uring 的统计信息（未使用时为空）
+        io_ring_stats ring_stats() const;
+        // 当前各文件追加日志的统计信息之和
+        append_log_stats append_stats() const;
         // 停止任务
         void stop()             noexcept;
-        // 等待任务完成
+        // 等待任务完成（包括请求的完成回调）；不能在完成回调中调用
         void wait()             const noexcept;
 
         // 添加写入任务
+        // 追加模式下同一文件的偏移量由该文件的追加日志依次分配，并发追加不互相覆盖；
+        // 小块数据复制后与同一文件的其他追加合并为一次写入，data 在返回后即可修改
         void add_write(fs::path path, std::vector<byte>& data, mode mode = mode::cover) noexcept;
         // 添加读取任务
         void add_read(fs::path path, std::vector<byte>& data) noexcept;
+
+        // 添加写入任务，整个请求结束（最后一块完成或未能提交）后调用 on_complete
+        void add_write(fs::path path, std::vector<byte>& data, mode mode, std::function<void()> on_complete) noexcept;
+        // 添加读取任务，整个请求结束（最后一块完成或未能提交）后调用 on_complete
+        void add_read(fs::path path, std::vector<byte>& data, std::function<void()> on_complete) noexcept;
+
+        // 添加写入任务，整个请求结束后在完成最后一块的线程上以结果调用 on_result
+        // （与 on_complete 的重载分开命名：两种 std::function 都能从 nullptr 或泛型 lambda 构造）
+        // 打开失败、停止后提交等情况下在当前线程上立即调用
+        // 使用 io_uring 时：有线程池则交给线程池调用；否则在 io_uring 的收割线程上调用，
+        // 该线程负责所有读写的完成，回调不能阻塞（on_complete 同理）
+        void add_write_result(fs::path path, std::vector<byte>& data, mode mode, file_callback on_result) noexcept;
+        // 添加读取任务，整个请求结束后在完成最后一块的线程上以结果调用 on_result
+        void add_read_result(fs::path path, std::vector<byte>& data, file_callback on_result) noexcept;
+
+        // 添加映射任务：只读映射整个文件到 file，通过 file.span() / file.view() 直接访问，不复制
+        // hint 为 willneed 且有线程池时，按分块大小在线程池中并行读入并建立页表，全部完成后调用 on_complete；
+        // 否则映射后立即调用（页面在首次访问时读入）。失败时 file 为未打开的对象
+        void add_map(fs::path path, mapped_file& file, map_hint hint = map_hint::sequential,
+            std::function<void()> on_complete = nullptr) noexcept;
+        // 添加映射任务，结束后以结果调用 on_result（bytes 为映射或预读的字节数）
+        void add_map_result(fs::path path, mapped_file& file, map_hint hint, file_callback on_result) noexcept;
+    private:
+        // 单个请求的完成状态，由各分块共同持有
+        struct request_state {
+            // 未完成的分块数，提交期间额外持有 1
+            std::atomic<u64>        remaining{ 1 };
+            // 各分块累计的字节数
+            std::atomic<u64>        bytes{ 0 };
+            // 第一个错误：抢到 failed 的分块写入 error，最后一块结束时读取
+            std::atomic<bool>       failed{ false };
+            std::error_code         error;
+            std::function<void()>   on_complete;
+            file_callback           on_result;
+        };
+        using request_ptr = std::shared_ptr<request_state>;
     private:
         // 剩余任务计数器
-        std::atomic<u64>    task_count_{ 0 };
+        tools::thread::inflight_counter task_count_;
+        // 分块延迟
+        tools::time::latency_histogram write_latency_;
+        tools::time::latency_histogram read_latency_;
         // 运行标志
         std::atomic<bool>   is_running_{ true };
         // 分块大小
@@ -48,11 +152,100 @@ namespace tools::file {
         // 线程池
         tools::thread::pool* thread_pool_;
         bool                owner_pool_ = false;
+        // 文件句柄缓存
+        handle_cache*       handles_ = nullptr;
+        std::unique_ptr<handle_cache> owned_handles_;
+        // io_uring（不支持或未启用时为空）
+        std::unique_ptr<io_ring> ring_;
+        // 各文件的追加日志
+        sync_policy         append_sync_;
+        mutable std::mutex  logs_mutex_;
+        std::unique_ptr<tools::thread::pool> log_pool_;
+        std::unordered_map<std::string, std::shared_ptr<append_log>> logs_;
     private:
-        // 写入函数
-        void _write_(fs::path path, byte* data, u64 byte_size, u64 skip_byte_size)  noexcept;
-        // 读取函数
-        void _read_(fs::path path, byte* data, u64 byte_size, u64 skip_byte_size)   noexcept;
+        // 只指定线程池、分块大小与句柄缓存的配置，其余字段取默认值
+        static file_pool_options _make_options_(tools::thread::pool* thread_pool, u64 block_size, handle_cache* handles) noexcept;
+        // 创建请求状态（没有回调时为空）
+        static request_ptr _make_request_(std::function<void()> on_complete, file_callback on_result);
+        // 记录一个分块的结果，只保留第一个错误
+        static void _record_(const request_ptr& request, u64 bytes, const std::error_code& ec) noexcept;
+        // 请求的一个分块结束，最后一块触发回调；completions 不为空时把回调交给该线程池（拒绝时在当前线程调用）
+        // counted 为 true 时在回调返回后才结束该分块的任务计数，wait() 返回时回调都已结束
+        void _finish_(const request_ptr& request, bool counted = false, tools::thread::pool* completions = nullptr) noexcept;
+        // 以请求的结果调用回调
+        static void _notify_(const request_ptr& request) noexcept;
+        // 提交一个分块任务：chunk(ec) 返回读写的字节数，完成后记录结果与延迟，线程池拒绝时立即结束该分块
+        template<typename F>
+        void _submit_(const request_ptr& request, tools::time::latency_histogram& latency, F&& chunk);
+        // 创建一个 io_uring 分块操作，完成后记录延迟并结束该分块
+        io_operation_ptr _make_operation_(const request_ptr& request, tools::time::latency_histogram& latency,
+            io_operation::kind kind, const file_handle_ptr& file, byte* data, u64 byte_size, u64 skip_byte_size);
+
+        // 提交读写或映射（请求状态为空时不报告结果）
+        void _add_write_(fs::path path, std::vector<byte>& data, mode mode, const request_ptr& request) noexcept;
+        void _add_read_(fs::path path, std::vector<byte>& data, const request_ptr& request) noexcept;
+        void _add_map_(fs::path path, mapped_file& file, map_hint hint, const request_ptr& request) noexcept;
+
+        // 取得文件的追加日志，句柄缓存重新打开了文件（被删除或替换）时换用新的日志
+        std::shared_ptr<append_log> _log_(const fs::path& path, const file_handle_ptr& file);
+        // 覆盖写入前关闭文件的追加日志
+        void _drop_log_(const fs::path& path);
+        // 把一次小块追加交给追加日志，写入后结束该分块
+        void _append_(append_log& log, const std::vector<byte>& data, const request_ptr& request);
+
+        // 写入函数，返回写入的字节数
+        u64 _write_(const file_handle& file, byte* data, u64 byte_size, u64 skip_byte_size, std::error_code& ec)  noexcept;
+        // 读取函数，返回读取的字节数
+        u64 _read_(const file_handle& file, byte* data, u64 byte_size, u64 skip_byte_size, std::error_code& ec)   noexcept;
     };
 
+    // 协程等待文件读写完成：file_result result = co_await async_read(files, path, data)
+    // 在完成最后一块的线程上恢复；请求未能提交时立即恢复
+    // 使用 io_uring 且没有线程池时在收割线程上恢复，协程在下一次挂起前不能阻塞
+    class file_awaiter {
+    public:
+        file_awaiter(file_task_pool& files, fs::path path, std::vector<byte>& data, bool read, mode mode) noexcept
+            : files(files), path(std::move(path)), data(data), read(read), write_mode(mode) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            // 回调可能在提交过程中直接恢复协程，之后不再访问本对象
+            file_callback resume = [this, h](const file_result& r) {
+                result = r;
+                h.resume();
+                };
+            if (read) {
+                files.add_read_result(std::move(path), data, std::move(resume));
+            }
+            else {
+                files.add_write_result(std::move(path), data, write_mode, std::move(resume));
+            }
+        }
+
+        file_result await_resume() const noexcept {
+            return result;
+        }
+
+    private:
+        file_task_pool& files;
+        fs::path path;
+        std::vector<byte>& data;
+        bool read;
+        mode write_mode;
+        file_result result;
+    };
+
+    // 等待读取完成
+    inline file_awaiter async_read(file_task_pool& files, fs::path path, std::vector<byte>& data) noexcept {
+        return file_awaiter(files, std::move(path), data, true, mode::cover);
+    }
+
+    // 等待写入完成
+    inline file_awaiter async_write(file_task_pool& files, fs::path path, std::vector<byte>& data, mode mode = mode::cover) noexcept {
+        return file_awaiter(files, std::move(path), data, false, mode);
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,332 @@
+#include "handle_cache.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef _WIN32
+// Windows.h 的 min/max 宏会破坏 std::min/std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tools::file {
+    namespace {
+        // 单次系统调用的最大字节数
+        constexpr u64 max_io = u64(1) << 30;
+
+#ifdef _WIN32
+        std::error_code last_error() noexcept {
+            return std::error_code(static_cast<int>(GetLastError()), std::system_category());
+        }
+
+        OVERLAPPED at_offset(u64 offset) noexcept {
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            return overlapped;
+        }
+#else
+        std::error_code last_error() noexcept {
+            return std::error_code(errno, std::generic_category());
+        }
+#endif
+    }
+
+    file_handle_ptr file_handle::open(const fs::path& path, access mode, std::error_code& ec) noexcept {
+        ec.clear();
+        file_handle_ptr file;
+        try {
+            file.reset(new file_handle());
+        }
+        catch (...) {
+            ec = std::make_error_code(std::errc::not_enough_memory);
+            return nullptr;
+        }
+        file->mode = mode;
+
+#ifdef _WIN32
+        DWORD desired = mode == access::read_write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+        DWORD disposition = mode == access::read_write ? OPEN_ALWAYS : OPEN_EXISTING;
+        HANDLE h = CreateFileW(path.c_str(), desired, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (h == INVALID_HANDLE_VALUE) {
+            ec = last_error();
+            return nullptr;
+        }
+        file->handle = h;
+        if (GetFileType(h) != FILE_TYPE_DISK) {
+            ec = std::make_error_code(std::errc::invalid_argument);
+            return nullptr;
+        }
+#else
+        int flags = (mode == access::read_write ? O_RDWR | O_CREAT : O_RDONLY) | O_CLOEXEC;
+        int fd;
+        do {
+            fd = ::open(path.c_str(), flags, 0644);
+        } while (fd < 0 && errno == EINTR);
+        if (fd < 0) {
+            ec = last_error();
+            return nullptr;
+        }
+        file->fd = fd;
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ec = last_error();
+            return nullptr;
+        }
+        // 只接受普通文件（目录也能以只读方式打开）
+        if (!S_ISREG(st.st_mode)) {
+            ec = std::make_error_code(S_ISDIR(st.st_mode) ? std::errc::is_a_directory : std::errc::invalid_argument);
+            return nullptr;
+        }
+        file->device = static_cast<u64>(st.st_dev);
+        file->inode = static_cast<u64>(st.st_ino);
+#endif
+        return file;
+    }
+
+    file_handle::~file_handle() {
+#ifdef _WIN32
+        if (handle) CloseHandle(static_cast<HANDLE>(handle));
+#else
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    u64 file_handle::read_at(byte* data, u64 size, u64 offset, std::error_code& ec) const noexcept {
+        ec.clear();
+        u64 done = 0;
+        while (done < size) {
+            u64 want = std::min(size - done, max_io);
+#ifdef _WIN32
+            OVERLAPPED overlapped = at_offset(offset + done);
+            DWORD got = 0;
+            if (!ReadFile(static_cast<HANDLE>(handle), data + done, static_cast<DWORD>(want), &got, &overlapped)) {
+                if (GetLastError() == ERROR_HANDLE_EOF) break;
+                ec = last_error();
+                break;
+            }
+#else
+            ssize_t got = ::pread(fd, data + done, static_cast<size_t>(want), static_cast<off_t>(offset + done));
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                ec = last_error();
+                break;
+            }
+#endif
+            if (got == 0) break;
+            done += static_cast<u64>(got);
+        }
+        return done;
+    }
+
+    u64 file_handle::write_at(const byte* data, u64 size, u64 offset, std::error_code& ec) const noexcept {
+        ec.clear();
+        if (!writable()) {
+            ec = std::make_error_code(std::errc::bad_file_descriptor);
+            return 0;
+        }
+        u64 done = 0;
+        while (done < size) {
+            u64 want = std::min(size - done, max_io);
+#ifdef _WIN32
+            OVERLAPPED overlapped = at_offset(offset + done);
+            DWORD put = 0;
+            if (!WriteFile(static_cast<HANDLE>(handle), data + done, static_cast<DWORD>(want), &put, &overlapped)) {
+                ec = last_error();
+                break;
+            }
+#else
+            ssize_t put = ::pwrite(fd, data + done, static_cast<size_t>(want), static_cast<off_t>(offset + done));
+            if (put < 0) {
+                if (errno == EINTR) continue;
+                ec = last_error();
+                break;
+            }
+#endif
+            if (put == 0) {
+                ec = std::make_error_code(std::errc::io_error);
+                break;
+            }
+            done += static_cast<u64>(put);
+        }
+        return done;
+    }
+
+    u64 file_handle::size(std::error_code& ec) const noexcept {
+        ec.clear();
+#ifdef _WIN32
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(static_cast<HANDLE>(handle), &size)) {
+            ec = last_error();
+            return 0;
+        }
+        return static_cast<u64>(size.QuadPart);
+#else
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ec = last_error();
+            return 0;
+        }
+        return static_cast<u64>(st.st_size);
+#endif
+    }
+
+    void file_handle::resize(u64 size, std::error_code& ec) const noexcept {
+        ec.clear();
+#ifdef _WIN32
+        FILE_END_OF_FILE_INFO info{};
+        info.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFileInformationByHandle(static_cast<HANDLE>(handle), FileEndOfFileInfo, &info, sizeof(info))) {
+            ec = last_error();
+        }
+#else
+        while (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            if (errno != EINTR) {
+                ec = last_error();
+                return;
+            }
+        }
+#endif
+    }
+
+    void file_handle::sync(std::error_code& ec) const noexcept {
+        ec.clear();
+#ifdef _WIN32
+        if (!FlushFileBuffers(static_cast<HANDLE>(handle))) {
+            ec = last_error();
+        }
+#else
+#if defined(__APPLE__)
+        // macOS 没有 fdatasync
+        while (::fsync(fd) != 0) {
+#else
+        while (::fdatasync(fd) != 0) {
+#endif
+            if (errno != EINTR) {
+                ec = last_error();
+                return;
+            }
+        }
+#endif
+    }
+
+    bool file_handle::same_file(const fs::path& path) const noexcept {
+#ifdef _WIN32
+        // 打开时允许删除，删除后路径不存在；替换为新文件的情况不检查
+        return GetFileAttributesW(path.c_str()) != INVALID_FILE_ATTRIBUTES;
+#else
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0) return false;
+        return static_cast<u64>(st.st_dev) == device && static_cast<u64>(st.st_ino) == inode;
+#endif
+    }
+
+    handle_cache::handle_cache(u64 max_open)
+        : limit(std::max<u64>(1, max_open)) {
+    }
+
+    file_handle_ptr handle_cache::acquire(const fs::path& path, access mode, std::error_code& ec) {
+        ec.clear();
+        std::string key = path.string();
+        std::vector<file_handle_ptr> closed;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = index.find(key);
+            if (found != index.end()) {
+                file_handle_ptr handle = found->second->handle;
+                if ((mode == access::read || handle->writable()) && handle->same_file(path)) {
+                    lru.splice(lru.begin(), lru, found->second);
+                    ++counters.hits;
+                    return handle;
+                }
+                // 只读句柄不能写入，或路径已指向其他文件：移出缓存后重新打开
+                if (mode == access::read || handle->writable()) ++counters.stale;
+                closed.push_back(std::move(found->second->handle));
+                lru.erase(found->second);
+                index.erase(found);
+            }
+            ++counters.misses;
+        }
+
+        // 在锁外打开，不阻塞其他路径的查找
+        file_handle_ptr opened = file_handle::open(path, mode, ec);
+        if (!opened) return nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = index.find(key);
+        if (found != index.end()) {
+            // 其他线程同时打开了同一路径，保留可满足本次访问的那个
+            if (mode == access::read || found->second->handle->writable()) {
+                lru.splice(lru.begin(), lru, found->second);
+                closed.push_back(std::move(opened));
+                return found->second->handle;
+            }
+            closed.push_back(std::move(found->second->handle));
+            lru.erase(found->second);
+            index.erase(found);
+        }
+        lru.push_front(entry{ std::move(key), opened });
+        index.emplace(lru.front().key, lru.begin());
+        evict(closed);
+        return opened;
+    }
+
+    void handle_cache::evict(std::vector<file_handle_ptr>& closed) {
+        auto it = lru.end();
+        while (lru.size() > limit && it != lru.begin()) {
+            --it;
+            // 仍被引用的句柄不关闭
+            if (it->handle.use_count() > 1) continue;
+            closed.push_back(std::move(it->handle));
+            index.erase(it->key);
+            it = lru.erase(it);
+            ++counters.evictions;
+        }
+    }
+
+    void handle_cache::invalidate(const fs::path& path) {
+        file_handle_ptr closed;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = index.find(path.string());
+        if (found == index.end()) return;
+        closed = std::move(found->second->handle);
+        lru.erase(found->second);
+        index.erase(found);
+    }
+
+    void handle_cache::clear() {
+        std::list<entry> closed;
+        std::lock_guard<std::mutex> lock(mutex);
+        index.clear();
+        closed.swap(lru);
+    }
+
+    void handle_cache::set_max_open(u64 max_open) {
+        std::vector<file_handle_ptr> closed;
+        std::lock_guard<std::mutex> lock(mutex);
+        limit = std::max<u64>(1, max_open);
+        evict(closed);
+    }
+
+    u64 handle_cache::max_open() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return limit;
+    }
+
+    handle_cache_stats handle_cache::stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        handle_cache_stats s = counters;
+        s.open = lru.size();
+        return s;
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace tools::file {
+    using byte = char;
+    namespace fs = std::filesystem;
+
+    // 打开方式
+    enum class access {
+        // 只读
+        read,
+        // 读写（文件不存在时创建）
+        read_write,
+    };
+
+    // 已打开的文件，最后一个引用释放时关闭
+    // 读写都指定偏移量，不移动文件位置，多个线程可同时使用同一个对象
+    class file_handle {
+    public:
+#ifdef _WIN32
+        using native_handle_type = void*;
+#else
+        using native_handle_type = int;
+#endif
+
+        // 打开普通文件，失败时返回空并设置 ec
+        static std::shared_ptr<file_handle> open(const fs::path& path, access mode, std::error_code& ec) noexcept;
+
+        ~file_handle();
+
+        file_handle(const file_handle&) = delete;
+        file_handle& operator=(const file_handle&) = delete;
+
+        // 从 offset 处读取 size 字节，返回实际读取的字节数（到达文件末尾时少于 size）
+        u64 read_at(byte* data, u64 size, u64 offset, std::error_code& ec) const noexcept;
+
+        // 在 offset 处写入 size 字节，返回实际写入的字节数
+        u64 write_at(const byte* data, u64 size, u64 offset, std::error_code& ec) const noexcept;
+
+        // 当前文件大小
+        u64 size(std::error_code& ec) const noexcept;
+
+        // 截断或扩展到 size 字节
+        void resize(u64 size, std::error_code& ec) const noexcept;
+
+        // 把已写入的数据刷到存储设备（POSIX 上为 fdatasync，不含不影响读取的元数据）
+        void sync(std::error_code& ec) const noexcept;
+
+        bool writable() const noexcept {
+            return mode == access::read_write;
+        }
+
+        // 系统句柄（POSIX 上为文件描述符）
+        native_handle_type native_handle() const noexcept {
+#ifdef _WIN32
+            return handle;
+#else
+            return fd;
+#endif
+        }
+
+        // 打开后路径是否仍指向同一个文件（文件被删除或替换后返回 false）
+        bool same_file(const fs::path& path) const noexcept;
+
+    private:
+        file_handle() = default;
+
+        access mode = access::read;
+#ifdef _WIN32
+        void* handle = nullptr;
+#else
+        int fd = -1;
+        // 打开时的设备号与 inode，用于判断路径是否已指向其他文件
+        u64 device = 0;
+        u64 inode = 0;
+#endif
+    };
+
+    using file_handle_ptr = std::shared_ptr<file_handle>;
+
+    // 句柄缓存统计信息
+    struct handle_cache_stats {
+        // 缓存中的句柄数
+        u64 open = 0;
+        // 命中次数
+        u64 hits = 0;
+        // 未命中（新打开）次数
+        u64 misses = 0;
+        // 因超出预算而关闭的句柄数
+        u64 evictions = 0;
+        // 路径已指向其他文件而重新打开的次数
+        u64 stale = 0;
+    };
+
+    // 按路径缓存已打开的文件，同一文件的并发读写共用一个描述符
+    // 缓存中的句柄数超过预算时按最久未使用的顺序关闭空闲句柄（仍被引用的句柄不关闭，暂时超出预算）
+    // 每次取得句柄时检查路径是否仍指向同一个文件（POSIX 上为一次 stat），文件被删除或替换后自动重新打开
+    class handle_cache {
+    public:
+        // max_open：缓存的句柄数上限
+        explicit handle_cache(u64 max_open = 256);
+
+        handle_cache(const handle_cache&) = delete;
+        handle_cache& operator=(const handle_cache&) = delete;
+
+        // 取得路径对应的句柄，需要写入而缓存的句柄只读时以读写方式重新打开
+        // 失败时返回空并设置 ec
+        file_handle_ptr acquire(const fs::path& path, access mode, std::error_code& ec);
+
+        // 从缓存中移除路径（已取得的句柄仍可使用）
+        void invalidate(const fs::path& path);
+
+        // 移除所有句柄
+        void clear();
+
+        // 修改预算，超出部分立即关闭
+        void set_max_open(u64 max_open);
+
+        u64 max_open() const;
+
+        handle_cache_stats stats() const;
+
+    private:
+        struct entry {
+            std::string key;
+            file_handle_ptr handle;
+        };
+
+        // 超出预算时从最久未使用的一端移除空闲句柄，移出的句柄放入 closed，在锁外关闭
+        void evict(std::vector<file_handle_ptr>& closed);
+
+        mutable std::mutex mutex;
+        // 最近使用的在前
+        std::list<entry> lru;
+        std::unordered_map<std::string, std::list<entry>::iterator> index;
+        u64 limit;
+        handle_cache_stats counters;
+    };
+}
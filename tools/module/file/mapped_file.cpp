@@ -0,0 +1,245 @@
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+// Windows.h 的 min/max 宏会破坏 std::min/std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tools::file {
+    namespace {
+        // 透明大页的大小
+        constexpr u64 huge_page = 2 * 1024 * 1024;
+
+        u64 page_size() noexcept {
+#ifdef _WIN32
+            static const u64 size = [] {
+                SYSTEM_INFO info;
+                GetSystemInfo(&info);
+                return static_cast<u64>(info.dwPageSize);
+            }();
+#else
+            static const u64 size = static_cast<u64>(::sysconf(_SC_PAGESIZE));
+#endif
+            return size;
+        }
+
+        // 逐页读取一个字节，使页面读入内存
+        void touch_pages(const byte* data, u64 size) noexcept {
+            u64 step = page_size();
+            volatile byte sink = 0;
+            for (u64 i = 0; i < size; i += step) sink = data[i];
+            if (size) sink = data[size - 1];
+            (void)sink;
+        }
+
+#ifdef _WIN32
+        std::error_code last_error() noexcept {
+            return std::error_code(static_cast<int>(GetLastError()), std::system_category());
+        }
+#else
+        std::error_code last_error() noexcept {
+            return std::error_code(errno, std::generic_category());
+        }
+
+        int advice_of(map_hint hint) noexcept {
+            switch (hint) {
+            case map_hint::sequential: return MADV_SEQUENTIAL;
+            case map_hint::random: return MADV_RANDOM;
+            case map_hint::willneed: return MADV_WILLNEED;
+            default: return MADV_NORMAL;
+            }
+        }
+
+        // 按 2 MiB 对齐映射：先保留多出 2 MiB 的地址空间，再把文件固定映射到对齐处，释放两端多余部分
+        void* map_aligned(int fd, u64 size) noexcept {
+            u64 reserve_size = size + huge_page;
+            void* reserve = ::mmap(nullptr, reserve_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (reserve == MAP_FAILED) return MAP_FAILED;
+
+            auto base = reinterpret_cast<uintptr_t>(reserve);
+            uintptr_t aligned = (base + huge_page - 1) & ~static_cast<uintptr_t>(huge_page - 1);
+            void* mapped = ::mmap(reinterpret_cast<void*>(aligned), size, PROT_READ, MAP_SHARED | MAP_FIXED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::munmap(reserve, reserve_size);
+                return MAP_FAILED;
+            }
+
+            uintptr_t mapped_end = aligned + (size + page_size() - 1) / page_size() * page_size();
+            uintptr_t reserve_end = base + reserve_size;
+            if (aligned > base) ::munmap(reserve, aligned - base);
+            if (reserve_end > mapped_end) ::munmap(reinterpret_cast<void*>(mapped_end), reserve_end - mapped_end);
+            return mapped;
+        }
+#endif
+    }
+
+    mapped_file mapped_file::map(const fs::path& path, map_hint hint, std::error_code& ec) noexcept {
+        ec.clear();
+        mapped_file result;
+
+#ifdef _WIN32
+        DWORD flags = FILE_ATTRIBUTE_NORMAL;
+        if (hint == map_hint::sequential) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+        if (hint == map_hint::random) flags |= FILE_FLAG_RANDOM_ACCESS;
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            ec = last_error();
+            return result;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            ec = last_error();
+            CloseHandle(file);
+            return result;
+        }
+        if (size.QuadPart == 0) {
+            CloseHandle(file);
+            result.opened = true;
+            return result;
+        }
+        // 视图保持映射对象有效，两个句柄都可以立即关闭
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) {
+            ec = last_error();
+            return result;
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view) {
+            ec = last_error();
+            return result;
+        }
+        result.address = static_cast<const byte*>(view);
+        result.length = static_cast<u64>(size.QuadPart);
+        result.opened = true;
+        result.advise(hint);
+#else
+        int fd;
+        do {
+            fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        } while (fd < 0 && errno == EINTR);
+        if (fd < 0) {
+            ec = last_error();
+            return result;
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ec = last_error();
+            ::close(fd);
+            return result;
+        }
+        // 只映射普通文件
+        if (!S_ISREG(st.st_mode)) {
+            ec = std::make_error_code(S_ISDIR(st.st_mode) ? std::errc::is_a_directory : std::errc::invalid_argument);
+            ::close(fd);
+            return result;
+        }
+        u64 size = static_cast<u64>(st.st_size);
+        if (size == 0) {
+            ::close(fd);
+            result.opened = true;
+            return result;
+        }
+
+        void* mapped = size >= huge_page
+            ? map_aligned(fd, size)
+            : ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ec = last_error();
+            ::close(fd);
+            return result;
+        }
+        // 映射保持文件有效，描述符可以立即关闭
+        ::close(fd);
+
+        result.address = static_cast<const byte*>(mapped);
+        result.length = size;
+        result.opened = true;
+#ifdef MADV_HUGEPAGE
+        if (size >= huge_page) {
+            result.huge = ::madvise(mapped, size, MADV_HUGEPAGE) == 0;
+        }
+#endif
+        result.advise(hint);
+#endif
+        return result;
+    }
+
+    mapped_file::mapped_file(mapped_file&& other) noexcept
+        : address(std::exchange(other.address, nullptr)),
+        length(std::exchange(other.length, 0)),
+        opened(std::exchange(other.opened, false)),
+        huge(std::exchange(other.huge, false)) {
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+        if (this != &other) {
+            close();
+            address = std::exchange(other.address, nullptr);
+            length = std::exchange(other.length, 0);
+            opened = std::exchange(other.opened, false);
+            huge = std::exchange(other.huge, false);
+        }
+        return *this;
+    }
+
+    mapped_file::~mapped_file() {
+        close();
+    }
+
+    void mapped_file::close() noexcept {
+        if (address) {
+#ifdef _WIN32
+            UnmapViewOfFile(address);
+#else
+            ::munmap(const_cast<byte*>(address), length);
+#endif
+        }
+        address = nullptr;
+        length = 0;
+        opened = false;
+        huge = false;
+    }
+
+    void mapped_file::advise(map_hint hint, u64 offset, u64 size) const noexcept {
+        if (!address || offset >= length) return;
+        size = std::min(size, length - offset);
+#ifdef _WIN32
+        // 只有即将访问的提示有对应的接口，其余在打开文件时指定
+        if (hint == map_hint::willneed) {
+            WIN32_MEMORY_RANGE_ENTRY range{ const_cast<byte*>(address + offset), static_cast<SIZE_T>(size) };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+#else
+        // madvise 的起始地址须按页对齐
+        u64 start = offset / page_size() * page_size();
+        ::madvise(const_cast<byte*>(address + start), size + (offset - start), advice_of(hint));
+#endif
+    }
+
+    void mapped_file::populate(u64 offset, u64 size) const noexcept {
+        if (!address || offset >= length) return;
+        size = std::min(size, length - offset);
+#if defined(MADV_POPULATE_READ)
+        u64 start = offset / page_size() * page_size();
+        // 5.14 之前的内核不支持，退回逐页访问
+        if (::madvise(const_cast<byte*>(address + start), size + (offset - start), MADV_POPULATE_READ) == 0) return;
+#endif
+        touch_pages(address + offset, size);
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+namespace tools::file {
+    using byte = char;
+    namespace fs = std::filesystem;
+
+    // 映射区域的访问方式提示
+    enum class map_hint {
+        // 不提示
+        normal,
+        // 顺序访问：加大预读，读过的页可尽早回收
+        sequential,
+        // 随机访问：关闭预读
+        random,
+        // 即将访问：立即开始后台读入
+        willneed,
+    };
+
+    // 只读映射整个文件，通过 span / string_view 直接访问文件内容，不复制
+    // 2 MiB 及以上的文件按 2 MiB 对齐映射并申请透明大页（内核与文件系统支持时生效）
+    // 映射期间文件被截断时，访问截断部分会产生 SIGBUS
+    class mapped_file {
+    public:
+        mapped_file() noexcept = default;
+
+        // 映射文件，失败时返回未打开的对象并设置 ec；空文件得到已打开、长度为 0 的映射
+        static mapped_file map(const fs::path& path, map_hint hint, std::error_code& ec) noexcept;
+
+        mapped_file(mapped_file&& other) noexcept;
+        mapped_file& operator=(mapped_file&& other) noexcept;
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        ~mapped_file();
+
+        // 解除映射
+        void close() noexcept;
+
+        // 对 [offset, offset + size) 给出访问提示（范围超出时截到文件末尾）
+        void advise(map_hint hint, u64 offset = 0, u64 size = tools::size::max<u64>()) const noexcept;
+
+        // 把 [offset, offset + size) 读入内存并建立页表，之后访问不再缺页（阻塞直到完成）
+        void populate(u64 offset = 0, u64 size = tools::size::max<u64>()) const noexcept;
+
+        bool is_open() const noexcept {
+            return opened;
+        }
+
+        u64 size() const noexcept {
+            return length;
+        }
+
+        bool empty() const noexcept {
+            return length == 0;
+        }
+
+        const byte* data() const noexcept {
+            return address;
+        }
+
+        const byte* begin() const noexcept {
+            return address;
+        }
+
+        const byte* end() const noexcept {
+            return address + length;
+        }
+
+        std::span<const byte> span() const noexcept {
+            return { address, static_cast<size_t>(length) };
+        }
+
+        std::string_view view() const noexcept {
+            return { address, static_cast<size_t>(length) };
+        }
+
+        // 是否申请到了大页（只表示内核接受了申请）
+        bool huge_pages() const noexcept {
+            return huge;
+        }
+
+    private:
+        const byte* address = nullptr;
+        u64 length = 0;
+        bool opened = false;
+        bool huge = false;
+    };
+}
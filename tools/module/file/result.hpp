@@ -0,0 +1,23 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <functional>
+#include <system_error>
+
+namespace tools::file {
+    // 单个读写请求的结果
+    struct file_result {
+        // 实际读写的字节数（读取时文件在提交后变短、或出错时小于请求的长度）
+        u64 bytes = 0;
+        // 第一个出错的步骤或分块的错误码，成功时为空
+        std::error_code error;
+
+        bool ok() const noexcept {
+            return !error;
+        }
+    };
+
+    // 请求结束时以结果调用的回调
+    using file_callback = std::function<void(const file_result&)>;
+}
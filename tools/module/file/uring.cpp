@@ -0,0 +1,411 @@
+#include "uring.hpp"
+
+#include "../thread/affinity.hpp"
+#include "../trace/trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define TOOLS_FILE_URING 1
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define TOOLS_FILE_URING 0
+#endif
+
+namespace tools::file {
+    namespace {
+        // 单次读写的最大字节数，更大的操作分多次续传
+        constexpr u64 max_io = u64(1) << 30;
+        // 唤醒收割线程退出的空操作
+        constexpr u64 stop_token = 0;
+    }
+
+#if TOOLS_FILE_URING
+    namespace {
+        int uring_setup(u32 entries, io_uring_params* params) noexcept {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int uring_enter(int fd, u32 to_submit, u32 min_complete, u32 flags) noexcept {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        int uring_register(int fd, u32 opcode, void* arg, u32 count) noexcept {
+            return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+        }
+
+        std::error_code errno_code(int error) noexcept {
+            return std::error_code(error, std::generic_category());
+        }
+
+        u32 load_acquire(const u32* p) noexcept {
+            return std::atomic_ref<const u32>(*p).load(std::memory_order_acquire);
+        }
+
+        void store_release(u32* p, u32 value) noexcept {
+            std::atomic_ref<u32>(*p).store(value, std::memory_order_release);
+        }
+    }
+
+    // 与内核共享的提交队列、完成队列
+    struct io_ring::rings {
+        int fd = -1;
+        void* sq_memory = MAP_FAILED;
+        size_t sq_bytes = 0;
+        void* cq_memory = MAP_FAILED;
+        size_t cq_bytes = 0;
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t sqe_bytes = 0;
+
+        u32* sq_head = nullptr;
+        u32* sq_tail = nullptr;
+        u32 sq_mask = 0;
+        u32 sq_entries = 0;
+        u32* sq_array = nullptr;
+
+        u32* cq_head = nullptr;
+        u32* cq_tail = nullptr;
+        u32 cq_mask = 0;
+        io_uring_cqe* cqes = nullptr;
+
+        explicit rings(u32 entries) {
+            io_uring_params params{};
+            fd = uring_setup(entries, &params);
+            if (fd < 0) {
+                throw std::system_error(errno_code(errno), "io_uring_setup failed");
+            }
+
+            sq_bytes = params.sq_off.array + params.sq_entries * sizeof(u32);
+            cq_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single) sq_bytes = cq_bytes = std::max(sq_bytes, cq_bytes);
+
+            sq_memory = ::mmap(nullptr, sq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sq_memory == MAP_FAILED) fail("io_uring sq mmap failed");
+            if (single) {
+                cq_memory = sq_memory;
+            }
+            else {
+                cq_memory = ::mmap(nullptr, cq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+                if (cq_memory == MAP_FAILED) fail("io_uring cq mmap failed");
+            }
+            sqe_bytes = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqe_memory = ::mmap(nullptr, sqe_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (sqe_memory == MAP_FAILED) fail("io_uring sqe mmap failed");
+            sqes = static_cast<io_uring_sqe*>(sqe_memory);
+
+            char* sq = static_cast<char*>(sq_memory);
+            sq_head = reinterpret_cast<u32*>(sq + params.sq_off.head);
+            sq_tail = reinterpret_cast<u32*>(sq + params.sq_off.tail);
+            sq_mask = *reinterpret_cast<u32*>(sq + params.sq_off.ring_mask);
+            sq_entries = params.sq_entries;
+            sq_array = reinterpret_cast<u32*>(sq + params.sq_off.array);
+
+            char* cq = static_cast<char*>(cq_memory);
+            cq_head = reinterpret_cast<u32*>(cq + params.cq_off.head);
+            cq_tail = reinterpret_cast<u32*>(cq + params.cq_off.tail);
+            cq_mask = *reinterpret_cast<u32*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        }
+
+        ~rings() {
+            release();
+        }
+
+        [[noreturn]] void fail(const char* what) {
+            std::error_code ec = errno_code(errno);
+            release();
+            throw std::system_error(ec, what);
+        }
+
+        void release() noexcept {
+            if (sqes != MAP_FAILED) ::munmap(sqes, sqe_bytes);
+            if (cq_memory != MAP_FAILED && cq_memory != sq_memory) ::munmap(cq_memory, cq_bytes);
+            if (sq_memory != MAP_FAILED) ::munmap(sq_memory, sq_bytes);
+            if (fd >= 0) ::close(fd);
+            sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+            cq_memory = sq_memory = MAP_FAILED;
+            fd = -1;
+        }
+
+        // 取得下一个提交项（调用方保证队列未满）
+        io_uring_sqe& next_sqe() noexcept {
+            u32 tail = *sq_tail;
+            u32 index = tail & sq_mask;
+            io_uring_sqe& sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sq_array[index] = index;
+            return sqe;
+        }
+
+        // 发布一个已填写的提交项
+        void publish() noexcept {
+            store_release(sq_tail, *sq_tail + 1);
+        }
+
+        // 提交队列中尚未被内核取走的项数（收割线程在锁外读取，尾部也按原子读取）
+        u32 unsubmitted() const noexcept {
+            return load_acquire(sq_tail) - load_acquire(sq_head);
+        }
+    };
+
+    bool io_ring::supported() noexcept {
+        static const bool result = [] {
+            io_uring_params params{};
+            int fd = uring_setup(4, &params);
+            if (fd < 0) return false;
+            // 需要 IORING_OP_READ / IORING_OP_WRITE（5.6 起）
+            constexpr u32 ops = 256;
+            std::vector<char> buffer(sizeof(io_uring_probe) + ops * sizeof(io_uring_probe_op), 0);
+            auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+            bool ok = uring_register(fd, IORING_REGISTER_PROBE, probe, ops) == 0
+                && probe->last_op >= IORING_OP_WRITE
+                && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)
+                && (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+            ::close(fd);
+            return ok;
+        }();
+        return result;
+    }
+
+    io_ring::io_ring(u32 queue_depth)
+        : depth(std::clamp<u32>(queue_depth, 1, 4096)) {
+        if (!supported()) {
+            throw std::system_error(std::make_error_code(std::errc::function_not_supported), "io_uring is not supported");
+        }
+        ring = std::make_unique<rings>(depth);
+        // 进行中的操作数不超过提交队列长度，完成队列（默认为提交队列的两倍）不会溢出
+        depth = std::min(depth, ring->sq_entries);
+        reaper = std::thread(&io_ring::reap, this);
+    }
+
+    io_ring::~io_ring() {
+        std::vector<io_operation*> canceled;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            canceled.assign(pending.begin(), pending.end());
+            pending.clear();
+            stopping = true;
+
+            // 空操作唤醒收割线程，收割线程处理完进行中的操作后退出
+            // 提交队列的项在进入内核时即被取走，进行中的操作不占用提交队列
+            io_uring_sqe& sqe = ring->next_sqe();
+            sqe.opcode = IORING_OP_NOP;
+            sqe.user_data = stop_token;
+            ring->publish();
+            while (uring_enter(ring->fd, ring->unsubmitted(), 0, 0) < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY)) {
+            }
+        }
+        reaper.join();
+
+        for (io_operation* op : canceled) {
+            op->error = std::make_error_code(std::errc::operation_canceled);
+            io_operation_ptr owner(op);
+            if (op->on_complete) op->on_complete(*op);
+        }
+    }
+
+    void io_ring::submit(io_operation_ptr op) noexcept {
+        std::vector<io_operation_ptr> ops;
+        try {
+            ops.push_back(std::move(op));
+        }
+        catch (...) {
+            op->error = std::make_error_code(std::errc::not_enough_memory);
+            if (op->on_complete) op->on_complete(*op);
+            return;
+        }
+        submit(ops);
+    }
+
+    void io_ring::submit(std::vector<io_operation_ptr>& ops) noexcept {
+        std::vector<io_operation_ptr> rejected;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& op : ops) {
+                try {
+                    if (stopping) throw std::system_error(std::make_error_code(std::errc::operation_canceled));
+                    pending.push_back(op.get());
+                    op.release();
+                }
+                catch (const std::system_error& e) {
+                    op->error = e.code();
+                    rejected.push_back(std::move(op));
+                }
+                catch (...) {
+                    op->error = std::make_error_code(std::errc::not_enough_memory);
+                    rejected.push_back(std::move(op));
+                }
+            }
+            flush();
+        }
+        ops.clear();
+
+        for (auto& op : rejected) {
+            if (op->on_complete) op->on_complete(*op);
+        }
+    }
+
+    void io_ring::flush() {
+        u32 filled = 0;
+        while (inflight < depth && !pending.empty()) {
+            io_operation* op = pending.front();
+            pending.pop_front();
+
+            io_uring_sqe& sqe = ring->next_sqe();
+            sqe.opcode = op->op == io_operation::kind::read ? IORING_OP_READ : IORING_OP_WRITE;
+            sqe.fd = op->file->native_handle();
+            sqe.addr = reinterpret_cast<u64>(op->data + op->done);
+            sqe.len = static_cast<u32>(std::min(op->size - op->done, max_io));
+            sqe.off = op->offset + op->done;
+            sqe.user_data = reinterpret_cast<u64>(op);
+            ring->publish();
+
+            ++inflight;
+            ++filled;
+        }
+        if (filled == 0) return;
+
+        counters.submitted += filled;
+        ++counters.enter_calls;
+        TOOLS_TRACE_COUNTER("file", "uring_inflight", inflight);
+        // 一次系统调用提交整批
+        // 内核暂时无法接收（EAGAIN 资源不足、EBUSY 完成队列溢出）时退避重试：这些操作已计入进行中，
+        // 若留在队列里而内核中没有其他操作，收割线程不会醒来，等待方永远等不到完成
+        u32 attempts = 0;
+        while (ring->unsubmitted() > 0) {
+            int n = uring_enter(ring->fd, ring->unsubmitted(), 0, 0);
+            if (n >= 0 || errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EBUSY) break;
+            if (++attempts < 64) {
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    bool io_ring::advance(io_operation& op, i32 result) noexcept {
+        if (result < 0) {
+            if (result == -EINTR || result == -EAGAIN) return false;
+            op.error = errno_code(-result);
+            return true;
+        }
+        op.done += static_cast<u64>(result);
+        if (op.done >= op.size) return true;
+        // 读取到达文件末尾
+        if (result == 0 && op.op == io_operation::kind::read) return true;
+        if (result == 0) {
+            op.error = std::make_error_code(std::errc::io_error);
+            return true;
+        }
+        return false;
+    }
+
+    void io_ring::reap() {
+        tools::thread::set_current_thread_name("tools_uring");
+        bool stop_seen = false;
+        std::vector<std::pair<io_operation*, i32>> reaped;
+        std::vector<io_operation*> finished;
+        std::vector<io_operation*> retry;
+
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stop_seen && inflight == 0) break;
+            }
+            // 同时提交队列中遗留的项（提交方遇到不可重试的错误时），不让它们只能等下一次提交
+            int n = uring_enter(ring->fd, ring->unsubmitted(), 1, IORING_ENTER_GETEVENTS);
+            if (n < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) break;
+
+            u32 head = *ring->cq_head;
+            u32 tail = load_acquire(ring->cq_tail);
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = ring->cqes[head & ring->cq_mask];
+                if (cqe.user_data == stop_token) {
+                    stop_seen = true;
+                    continue;
+                }
+                reaped.emplace_back(reinterpret_cast<io_operation*>(cqe.user_data), cqe.res);
+            }
+            store_release(ring->cq_head, head);
+            if (reaped.empty()) continue;
+
+            {
+                // 操作由提交方在锁内放入队列，在锁内读取其状态
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto& [op, result] : reaped) {
+                    (advance(*op, result) ? finished : retry).push_back(op);
+                }
+                reaped.clear();
+                inflight -= static_cast<u32>(finished.size() + retry.size());
+                counters.completed += finished.size();
+                counters.resubmitted += retry.size();
+                // 续传的操作排在最前，先于新操作提交
+                for (auto it = retry.rbegin(); it != retry.rend(); ++it) pending.push_front(*it);
+                retry.clear();
+                flush();
+            }
+
+            // 在锁外调用完成回调，回调中可以再提交
+            for (io_operation* op : finished) {
+                io_operation_ptr owner(op);
+                TOOLS_TRACE_INSTANT("file", "uring_complete", op->done);
+                if (op->on_complete) op->on_complete(*op);
+            }
+            finished.clear();
+        }
+    }
+
+    io_ring_stats io_ring::stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        io_ring_stats s = counters;
+        s.inflight = inflight;
+        s.pending = pending.size();
+        return s;
+    }
+#else
+    struct io_ring::rings {};
+
+    bool io_ring::supported() noexcept {
+        return false;
+    }
+
+    io_ring::io_ring(u32 queue_depth)
+        : depth(queue_depth) {
+        throw std::system_error(std::make_error_code(std::errc::function_not_supported), "io_uring is not supported");
+    }
+
+    io_ring::~io_ring() = default;
+
+    void io_ring::submit(io_operation_ptr op) noexcept {
+        op->error = std::make_error_code(std::errc::function_not_supported);
+        if (op->on_complete) op->on_complete(*op);
+    }
+
+    void io_ring::submit(std::vector<io_operation_ptr>& ops) noexcept {
+        for (auto& op : ops) submit(std::move(op));
+        ops.clear();
+    }
+
+    void io_ring::flush() {}
+
+    void io_ring::reap() {}
+
+    bool io_ring::advance(io_operation&, i32) noexcept {
+        return true;
+    }
+
+    io_ring_stats io_ring::stats() const {
+        return {};
+    }
+#endif
+}
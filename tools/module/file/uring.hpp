@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include "handle_cache.hpp"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace tools::file {
+    // io_ring 上的一次读写
+    struct io_operation {
+        enum class kind : u8 {
+            read,
+            write,
+        };
+
+        kind op = kind::read;
+        file_handle_ptr file;
+        byte* data = nullptr;
+        u64 size = 0;
+        u64 offset = 0;
+        // 已完成的字节数（读取到达文件末尾时小于 size）
+        u64 done = 0;
+        std::error_code error;
+        // 完成（全部字节、出错或到达文件末尾）后在收割线程上调用，之后操作被释放
+        // 所有操作共用一个收割线程，回调不能阻塞，否则其他操作的完成都会停滞
+        std::function<void(io_operation&)> on_complete;
+    };
+
+    using io_operation_ptr = std::unique_ptr<io_operation>;
+
+    // io_ring 统计信息
+    struct io_ring_stats {
+        // 提交给内核的读写次数（含续传）
+        u64 submitted = 0;
+        // 完成的操作数
+        u64 completed = 0;
+        // 短读写后续传的次数
+        u64 resubmitted = 0;
+        // 提交时的系统调用次数
+        u64 enter_calls = 0;
+        // 当前进行中的与排队中的操作数
+        u64 inflight = 0;
+        u64 pending = 0;
+    };
+
+    // 基于 io_uring 的异步文件读写（仅 Linux 5.6 及以上）
+    // 多个线程可同时提交，一批操作只进入内核一次；完成由一个收割线程处理
+    // 同时进行的操作数不超过队列深度，超出的先排队，有操作完成时再提交
+    class io_ring {
+    public:
+        // 当前系统是否支持（内核支持 io_uring 的读写操作且未被禁用）
+        static bool supported() noexcept;
+
+        // queue_depth：同时进行的操作数上限；失败时抛出 std::system_error
+        explicit io_ring(u32 queue_depth = 64);
+
+        // 等待进行中的操作完成；仍在排队的操作以 operation_canceled 结束
+        ~io_ring();
+
+        io_ring(const io_ring&) = delete;
+        io_ring& operator=(const io_ring&) = delete;
+
+        // 提交一批操作并取得其所有权（ops 被清空）
+        void submit(std::vector<io_operation_ptr>& ops) noexcept;
+
+        // 提交单个操作
+        void submit(io_operation_ptr op) noexcept;
+
+        u32 queue_depth() const noexcept {
+            return depth;
+        }
+
+        io_ring_stats stats() const;
+
+    private:
+        struct rings;
+
+        // 把排队的操作填入提交队列并进入内核，调用方持有 mutex
+        void flush();
+        // 收割线程
+        void reap();
+        // 按内核返回的结果推进操作，需要续传时返回 false
+        static bool advance(io_operation& op, i32 result) noexcept;
+
+        std::unique_ptr<rings> ring;
+        u32 depth;
+
+        mutable std::mutex mutex;
+        std::deque<io_operation*> pending;
+        u32 inflight = 0;
+        bool stopping = false;
+        io_ring_stats counters;
+
+        std::thread reaper;
+    };
+}
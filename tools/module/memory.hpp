@@ -0,0 +1,10 @@
+#pragma once
+
+// 分级对象池与标准分配器
+#include "memory/pool.hpp"
+
+// 单调分配区
+#include "memory/arena.hpp"
+
+// std::pmr 内存资源
+#include "memory/resource.hpp"
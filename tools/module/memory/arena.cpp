@@ -0,0 +1,77 @@
+#include "arena.hpp"
+
+#include <algorithm>
+
+namespace tools::memory {
+    monotonic_arena::monotonic_arena(u64 initial_chunk, u64 max_chunk)
+        : next_size(std::max<u64>(64, initial_chunk)), max_chunk(std::max(max_chunk, std::max<u64>(64, initial_chunk))) {}
+
+    monotonic_arena::~monotonic_arena() {
+        release();
+    }
+
+    void monotonic_arena::enter(u64 index) noexcept {
+        current = index;
+        cursor = reinterpret_cast<u64>(chunks[index].data);
+        limit = cursor + chunks[index].size;
+    }
+
+    void* monotonic_arena::allocate_slow(u64 size, u64 align) {
+        if (align == 0 || (align & (align - 1)) != 0) throw std::bad_alloc();
+
+        // 先尝试 reset 后保留下来的后续内存块
+        u64 start = chunks.empty() ? 0 : current + 1;
+        for (u64 i = start; i < chunks.size(); ++i) {
+            u64 base = reinterpret_cast<u64>(chunks[i].data);
+            u64 aligned = (base + align - 1) & ~(align - 1);
+            if (aligned - base + size <= chunks[i].size) {
+                enter(i);
+                return allocate(size, align);
+            }
+        }
+
+        // 新块放在当前块之后，后面保留的块仍可在本轮使用
+        u64 bytes = std::max(next_size, size + align);
+        char* data = static_cast<char*>(::operator new(bytes, std::align_val_t(alignof(std::max_align_t))));
+        u64 position = chunks.empty() ? 0 : current + 1;
+        try {
+            chunks.insert(chunks.begin() + static_cast<std::ptrdiff_t>(position), chunk{ data, bytes });
+        }
+        catch (...) {
+            ::operator delete(data, std::align_val_t(alignof(std::max_align_t)));
+            throw;
+        }
+        reserved += bytes;
+        next_size = std::min(max_chunk, next_size * 2);
+        enter(position);
+        return allocate(size, align);
+    }
+
+    void monotonic_arena::reset() noexcept {
+        allocated = 0;
+        ++resets;
+        if (chunks.empty()) return;
+        enter(0);
+    }
+
+    void monotonic_arena::release() noexcept {
+        for (chunk& c : chunks) {
+            ::operator delete(c.data, std::align_val_t(alignof(std::max_align_t)));
+        }
+        chunks.clear();
+        current = 0;
+        cursor = 0;
+        limit = 0;
+        allocated = 0;
+        reserved = 0;
+    }
+
+    arena_stats monotonic_arena::stats() const noexcept {
+        arena_stats s;
+        s.bytes_allocated = allocated;
+        s.chunks = chunks.size();
+        s.bytes_reserved = reserved;
+        s.resets = resets;
+        return s;
+    }
+}
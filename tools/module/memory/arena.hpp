@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace tools::memory {
+    // 单调分配区统计信息
+    struct arena_stats {
+        // 自上次重置以来分配出去的字节数（含对齐填充）
+        u64 bytes_allocated = 0;
+        // 持有的内存块数与总字节数
+        u64 chunks = 0;
+        u64 bytes_reserved = 0;
+        // 重置次数
+        u64 resets = 0;
+    };
+
+    // 单调分配区：指针递增分配，单个对象不释放，reset 后整体复用
+    // reset 保留已申请的内存块，下一轮从第一块重新开始；release 才归还系统
+    // 内存块按 2 倍增长，最大 max_chunk（超大请求单独成块）
+    // 不是线程安全的，每个线程或每个请求使用自己的分配区
+    class monotonic_arena {
+    public:
+        explicit monotonic_arena(u64 initial_chunk = 4 * 1024, u64 max_chunk = 1024 * 1024);
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+        ~monotonic_arena();
+
+        void* allocate(u64 size, u64 align = alignof(std::max_align_t)) {
+            // 零字节请求也返回唯一的地址
+            if (size == 0) size = 1;
+            u64 aligned = (cursor + align - 1) & ~(align - 1);
+            if (aligned <= limit && size <= limit - aligned) {
+                allocated += aligned + size - cursor;
+                cursor = aligned + size;
+                return reinterpret_cast<void*>(aligned);
+            }
+            return allocate_slow(size, align);
+        }
+
+        // 在分配区中构造对象；分配区不调用析构函数，T 应可平凡析构或由调用方析构
+        template<typename T, typename... Args>
+        T* create(Args&&... args) {
+            void* p = allocate(sizeof(T), alignof(T));
+            return ::new (p) T(std::forward<Args>(args)...);
+        }
+
+        // 未初始化的数组
+        template<typename T>
+        T* allocate_array(u64 count) {
+            return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        // 所有已分配的内存失效，保留内存块供下一轮使用
+        void reset() noexcept;
+
+        // 所有已分配的内存失效，并归还全部内存块
+        void release() noexcept;
+
+        arena_stats stats() const noexcept;
+
+    private:
+        struct chunk {
+            char* data;
+            u64 size;
+        };
+
+        void* allocate_slow(u64 size, u64 align);
+        void enter(u64 index) noexcept;
+
+        std::vector<chunk> chunks;
+        // 当前使用的内存块
+        u64 current = 0;
+        // 当前块中下一个可用地址与结束地址
+        u64 cursor = 0;
+        u64 limit = 0;
+        u64 next_size;
+        u64 max_chunk;
+        u64 allocated = 0;
+        u64 reserved = 0;
+        u64 resets = 0;
+    };
+}
@@ -0,0 +1,249 @@
+#include "pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace tools::memory {
+    namespace {
+        constexpr size_t class_count = size_class_pool::class_count;
+        constexpr size_t granularity = size_class_pool::granularity;
+        // 每次向系统申请的最小内存块
+        constexpr size_t chunk_bytes = 64 * 1024;
+
+        struct free_block {
+            free_block* next;
+        };
+
+        // 一批空闲块，整批在线程缓存与全局仓库之间移动
+        struct batch {
+            free_block* head;
+            u32 count;
+        };
+
+        // 每个等级的全局仓库
+        struct alignas(64) depot {
+            std::mutex mutex;
+            std::vector<batch> batches;
+            std::atomic<u64> chunks{ 0 };
+            std::atomic<u64> bytes_reserved{ 0 };
+            std::atomic<u64> batches_fetched{ 0 };
+            std::atomic<u64> batches_flushed{ 0 };
+            std::atomic<u64> depot_batches{ 0 };
+        };
+
+        // 仓库在进程退出时也不析构，其他静态对象析构时仍可归还内存
+        depot* depots() {
+            static depot* all = new depot[class_count];
+            return all;
+        }
+
+        std::atomic<u64> large_count{ 0 };
+
+        constexpr size_t class_of(size_t size) noexcept {
+            return (size + granularity - 1) / granularity - 1;
+        }
+
+        constexpr size_t block_size_of(size_t index) noexcept {
+            return (index + 1) * granularity;
+        }
+
+        // 每批块数：约 16 KiB，介于 8 与 256 之间
+        constexpr u32 batch_size_of(size_t index) noexcept {
+            return static_cast<u32>(std::clamp<size_t>(16 * 1024 / block_size_of(index), 8, 256));
+        }
+
+        // 线程缓存，可平凡析构，线程退出后仍可安全访问
+        struct thread_cache {
+            free_block* heads[class_count];
+            u32 counts[class_count];
+            bool dead;
+        };
+
+        thread_local thread_cache cache{};
+
+        void push_batch(size_t index, batch b) {
+            depot& d = depots()[index];
+            {
+                std::lock_guard<std::mutex> lock(d.mutex);
+                d.batches.push_back(b);
+            }
+            d.depot_batches.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // 从仓库取一批，仓库为空时返回空批
+        batch pop_batch(size_t index) {
+            depot& d = depots()[index];
+            std::lock_guard<std::mutex> lock(d.mutex);
+            if (d.batches.empty()) return { nullptr, 0 };
+            batch b = d.batches.back();
+            d.batches.pop_back();
+            d.depot_batches.fetch_sub(1, std::memory_order_relaxed);
+            return b;
+        }
+
+        void* allocate_chunk(size_t bytes) {
+            if constexpr (__STDCPP_DEFAULT_NEW_ALIGNMENT__ >= granularity) {
+                return ::operator new(bytes);
+            }
+            else {
+                return ::operator new(bytes, std::align_val_t(granularity));
+            }
+        }
+
+        // 向系统申请至少 count 个块并切分成批；第一批返回给调用方，其余放入仓库
+        batch carve(size_t index, u64 count) {
+            depot& d = depots()[index];
+            size_t block = block_size_of(index);
+            u32 per_batch = batch_size_of(index);
+            u64 blocks = std::max<u64>(count, std::max<u64>(per_batch, chunk_bytes / block));
+            size_t bytes = static_cast<size_t>(blocks) * block;
+            char* memory = static_cast<char*>(allocate_chunk(bytes));
+            d.chunks.fetch_add(1, std::memory_order_relaxed);
+            d.bytes_reserved.fetch_add(bytes, std::memory_order_relaxed);
+
+            batch first{ nullptr, 0 };
+            u64 i = 0;
+            while (i < blocks) {
+                u32 n = static_cast<u32>(std::min<u64>(per_batch, blocks - i));
+                free_block* head = nullptr;
+                for (u32 k = n; k > 0; --k) {
+                    auto* b = reinterpret_cast<free_block*>(memory + (i + k - 1) * block);
+                    b->next = head;
+                    head = b;
+                }
+                if (!first.head) first = { head, n };
+                else push_batch(index, { head, n });
+                i += n;
+            }
+            return first;
+        }
+
+        // 线程退出时把缓存整批归还仓库
+        struct cache_owner {
+            ~cache_owner() {
+                for (size_t i = 0; i < class_count; ++i) {
+                    if (cache.heads[i]) {
+                        push_batch(i, { cache.heads[i], cache.counts[i] });
+                        depots()[i].batches_flushed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    cache.heads[i] = nullptr;
+                    cache.counts[i] = 0;
+                }
+                cache.dead = true;
+            }
+        };
+
+        thread_cache& owned_cache() noexcept {
+            static thread_local cache_owner owner;
+            (void)owner;
+            return cache;
+        }
+
+        pool_stats stats_of(size_t index) noexcept {
+            depot& d = depots()[index];
+            pool_stats s;
+            s.block_size = block_size_of(index);
+            s.chunks = d.chunks.load(std::memory_order_relaxed);
+            s.bytes_reserved = d.bytes_reserved.load(std::memory_order_relaxed);
+            s.batches_fetched = d.batches_fetched.load(std::memory_order_relaxed);
+            s.batches_flushed = d.batches_flushed.load(std::memory_order_relaxed);
+            s.depot_batches = d.depot_batches.load(std::memory_order_relaxed);
+            return s;
+        }
+    }
+
+    void* size_class_pool::allocate(size_t size) {
+        if (size == 0) size = 1;
+        if (size > max_size) {
+            large_count.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+
+        size_t index = class_of(size);
+        if (cache.dead) {
+            // 线程退出阶段不再缓存，直接从仓库取一块
+            batch b = pop_batch(index);
+            if (!b.head) b = carve(index, 0);
+            free_block* block = b.head;
+            if (block->next) push_batch(index, { block->next, b.count - 1 });
+            return block;
+        }
+
+        thread_cache& local = owned_cache();
+        free_block* block = local.heads[index];
+        if (!block) {
+            batch b = pop_batch(index);
+            if (b.head) depots()[index].batches_fetched.fetch_add(1, std::memory_order_relaxed);
+            else b = carve(index, 0);
+            block = b.head;
+            local.counts[index] = b.count;
+        }
+        local.heads[index] = block->next;
+        --local.counts[index];
+        return block;
+    }
+
+    void size_class_pool::deallocate(void* p, size_t size) noexcept {
+        if (!p) return;
+        if (size == 0) size = 1;
+        if (size > max_size) {
+            ::operator delete(p);
+            return;
+        }
+
+        size_t index = class_of(size);
+        auto* block = static_cast<free_block*>(p);
+        try {
+            if (cache.dead) {
+                block->next = nullptr;
+                push_batch(index, { block, 1 });
+                return;
+            }
+
+            thread_cache& local = owned_cache();
+            block->next = local.heads[index];
+            local.heads[index] = block;
+            u32 per_batch = batch_size_of(index);
+            if (++local.counts[index] < per_batch * 2) return;
+
+            // 缓存达到两批时把前一批归还仓库，保留一批以免在边界上反复交换
+            free_block* tail = block;
+            for (u32 i = 1; i < per_batch; ++i) tail = tail->next;
+            local.heads[index] = tail->next;
+            tail->next = nullptr;
+            local.counts[index] -= per_batch;
+            push_batch(index, { block, per_batch });
+            depots()[index].batches_flushed.fetch_add(1, std::memory_order_relaxed);
+        }
+        catch (...) {
+            // 仓库扩容失败时放弃这批块（极少发生），不影响其他块
+        }
+    }
+
+    void size_class_pool::reserve(size_t size, u64 count) {
+        if (size == 0 || size > max_size || count == 0) return;
+        size_t index = class_of(size);
+        batch first = carve(index, count);
+        push_batch(index, first);
+    }
+
+    pool_stats size_class_pool::stats(size_t size) noexcept {
+        if (size == 0) size = 1;
+        if (size > max_size) return pool_stats();
+        return stats_of(class_of(size));
+    }
+
+    std::vector<pool_stats> size_class_pool::all_stats() {
+        std::vector<pool_stats> result;
+        for (size_t i = 0; i < class_count; ++i) {
+            pool_stats s = stats_of(i);
+            if (s.chunks != 0) result.push_back(s);
+        }
+        return result;
+    }
+
+    u64 size_class_pool::large_allocations() noexcept {
+        return large_count.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tools::memory {
+    // 单个尺寸等级的统计信息
+    struct pool_stats {
+        // 块大小
+        u64 block_size = 0;
+        // 向系统申请的内存块数与字节数（从不归还）
+        u64 chunks = 0;
+        u64 bytes_reserved = 0;
+        // 线程缓存从全局仓库取走、归还的批次数
+        u64 batches_fetched = 0;
+        u64 batches_flushed = 0;
+        // 全局仓库中现存的批次数
+        u64 depot_batches = 0;
+    };
+
+    // 按尺寸分级的对象池
+    // 不超过 max_size 的请求按 granularity 向上取整到所属等级，每个等级一条线程本地空闲链表，
+    // 线程缓存为空或过多时与全局仓库整批交换（仓库由互斥锁保护，锁的开销分摊到一批对象上）
+    // 块按 granularity 对齐；内存只进不出，线程退出时缓存归还仓库
+    // 超过 max_size 的请求直接使用 operator new
+    class size_class_pool {
+    public:
+        static constexpr size_t granularity = 16;
+        static constexpr size_t max_size = 1024;
+        static constexpr size_t class_count = max_size / granularity;
+
+        static void* allocate(size_t size);
+        // size 须与分配时相同
+        static void deallocate(void* p, size_t size) noexcept;
+
+        // 预先为 size 所属等级准备 count 个块，放入全局仓库
+        static void reserve(size_t size, u64 count);
+
+        // size 所属等级的统计信息
+        static pool_stats stats(size_t size) noexcept;
+        // 所有使用过的等级
+        static std::vector<pool_stats> all_stats();
+        // 超过 max_size、直接向系统申请的次数
+        static u64 large_allocations() noexcept;
+
+        // 该大小是否由分级池提供
+        static constexpr bool pooled(size_t size, size_t align = alignof(std::max_align_t)) noexcept {
+            return size != 0 && size <= max_size && align <= granularity;
+        }
+    };
+
+    // 固定类型的对象池，取自 T 所属的尺寸等级
+    template<typename T>
+    class object_pool {
+        static_assert(alignof(T) <= size_class_pool::granularity, "object_pool does not support over-aligned types");
+
+    public:
+        template<typename... Args>
+        static T* create(Args&&... args) {
+            void* p = size_class_pool::allocate(sizeof(T));
+            try {
+                return ::new (p) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                size_class_pool::deallocate(p, sizeof(T));
+                throw;
+            }
+        }
+
+        static void destroy(T* p) noexcept {
+            if (!p) return;
+            p->~T();
+            size_class_pool::deallocate(p, sizeof(T));
+        }
+
+        static void reserve(u64 count) {
+            size_class_pool::reserve(sizeof(T), count);
+        }
+
+        static pool_stats stats() noexcept {
+            return size_class_pool::stats(sizeof(T));
+        }
+    };
+
+    // 基于 size_class_pool 的标准分配器，可用于 std::vector、std::list 等容器
+    template<typename T>
+    class pool_allocator {
+    public:
+        using value_type = T;
+
+        pool_allocator() noexcept = default;
+
+        template<typename U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        T* allocate(size_t n) {
+            if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_array_new_length();
+            size_t bytes = n * sizeof(T);
+            if (size_class_pool::pooled(bytes, alignof(T))) {
+                return static_cast<T*>(size_class_pool::allocate(bytes));
+            }
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            size_t bytes = n * sizeof(T);
+            if (size_class_pool::pooled(bytes, alignof(T))) {
+                size_class_pool::deallocate(p, bytes);
+                return;
+            }
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        }
+
+        template<typename U>
+        bool operator==(const pool_allocator<U>&) const noexcept {
+            return true;
+        }
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include "arena.hpp"
+#include "pool.hpp"
+
+#include <memory_resource>
+
+namespace tools::memory {
+    // 以 size_class_pool 为后端的内存资源
+    // 不超过 size_class_pool::max_size 且对齐不超过 16 的请求取自分级池，其余交给上游资源
+    // 分级池是进程共享的，从一个 pool_resource 分配的内存可以交给另一个同上游的 pool_resource 释放
+    class pool_resource : public std::pmr::memory_resource {
+    public:
+        explicit pool_resource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+            : upstream(upstream) {}
+
+        std::pmr::memory_resource* upstream_resource() const noexcept {
+            return upstream;
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t align) override {
+            if (size_class_pool::pooled(bytes, align)) return size_class_pool::allocate(bytes);
+            return upstream->allocate(bytes, align);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t align) override {
+            if (size_class_pool::pooled(bytes, align)) {
+                size_class_pool::deallocate(p, bytes);
+                return;
+            }
+            upstream->deallocate(p, bytes, align);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            if (this == &other) return true;
+            auto* pool = dynamic_cast<const pool_resource*>(&other);
+            return pool && pool->upstream->is_equal(*upstream);
+        }
+
+    private:
+        std::pmr::memory_resource* upstream;
+    };
+
+    // 进程共享的 pool_resource，上游为 new/delete
+    inline pool_resource* default_pool_resource() noexcept {
+        static pool_resource resource;
+        return &resource;
+    }
+
+    // 以 monotonic_arena 为后端的内存资源：释放不做任何事，reset 后整体复用
+    // 适合生命周期与一次请求或一帧相同的临时容器；不是线程安全的
+    class arena_resource : public std::pmr::memory_resource {
+    public:
+        explicit arena_resource(u64 initial_chunk = 4 * 1024, u64 max_chunk = 1024 * 1024)
+            : arena(initial_chunk, max_chunk) {}
+
+        // 之前分配的内存全部失效，使用这些内存的容器须先销毁
+        void reset() noexcept {
+            arena.reset();
+        }
+
+        void release() noexcept {
+            arena.release();
+        }
+
+        arena_stats stats() const noexcept {
+            return arena.stats();
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t align) override {
+            return arena.allocate(bytes, align);
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        monotonic_arena arena;
+    };
+}
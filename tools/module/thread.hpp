@@ -3,8 +3,35 @@
 // 平台初始化
 #include "platform/enable_high_precision_thread_scheduler.hpp"
 
+// 无锁容器的内存回收
+#include "thread/reclaim.hpp"
+
+// 分片计数器
+#include "thread/counter.hpp"
+
 // 多线程容器
 #include "thread/thread_data.hpp"
 
+// 事件计数器
+#include "thread/event_count.hpp"
+
+// 任务类型
+#include "thread/task.hpp"
+
+// 任务结果
+#include "thread/future.hpp"
+
 // 线程池
-#include "thread/pool.hpp"
\ No newline at end of file
+#include "thread/pool.hpp"
+
+// 任务组与门闩
+#include "thread/task_group.hpp"
+
+// 数据并行算法
+#include "thread/parallel.hpp"
+
+// 定时器
+#include "thread/timer.hpp"
+
+// 协程任务
+#include "thread/coroutine.hpp"
@@ -0,0 +1,126 @@
+#include "affinity.hpp"
+
+#include "../trace/trace.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+// Windows.h 的 min/max 宏会破坏 std::min/std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+namespace tools::thread {
+    namespace {
+        // 全部 CPU 组成的单个节点
+        std::vector<numa_node> single_node() {
+            numa_node node;
+            u32 n = std::max(1u, std::thread::hardware_concurrency());
+            for (u32 i = 0; i < n; ++i) node.cpus.push_back(i);
+            return { node };
+        }
+    }
+
+    std::vector<u32> parse_cpu_list(const std::string& text) {
+        std::vector<u32> cpus;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (item.empty() || item == "\n") continue;
+            try {
+                size_t dash = item.find('-');
+                u32 first = static_cast<u32>(std::stoul(item.substr(0, dash)));
+                u32 last = dash == std::string::npos ? first : static_cast<u32>(std::stoul(item.substr(dash + 1)));
+                for (u32 cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+            }
+            catch (...) {
+                // 忽略无法解析的片段
+            }
+        }
+        return cpus;
+    }
+
+#ifdef _WIN32
+    std::vector<numa_node> numa_topology() {
+        return single_node();
+    }
+
+    bool pin_current_thread(const std::vector<u32>& cpus) {
+        DWORD_PTR mask = 0;
+        for (u32 cpu : cpus) {
+            if (cpu < sizeof(DWORD_PTR) * 8) mask |= DWORD_PTR(1) << cpu;
+        }
+        return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+    }
+
+    void set_current_thread_name(const std::string& name) {
+        std::wstring wide(name.begin(), name.end());
+        SetThreadDescription(GetCurrentThread(), wide.c_str());
+        tools::trace::set_thread_name(name);
+    }
+
+    i32 current_cpu() {
+        return static_cast<i32>(GetCurrentProcessorNumber());
+    }
+#else
+    std::vector<numa_node> numa_topology() {
+        std::vector<numa_node> nodes;
+        const std::string root = "/sys/devices/system/node";
+        DIR* dir = opendir(root.c_str());
+        if (!dir) return single_node();
+
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0) continue;
+            if (name.find_first_not_of("0123456789", 4) != std::string::npos) continue;
+
+            std::ifstream file(root + "/" + name + "/cpulist");
+            std::string list;
+            if (!file || !std::getline(file, list)) continue;
+
+            numa_node node;
+            node.id = static_cast<u32>(std::stoul(name.substr(4)));
+            node.cpus = parse_cpu_list(list);
+            // 没有 CPU 的节点（纯内存节点）不参与调度
+            if (!node.cpus.empty()) nodes.push_back(std::move(node));
+        }
+        closedir(dir);
+
+        if (nodes.empty()) return single_node();
+        std::sort(nodes.begin(), nodes.end(), [](const numa_node& a, const numa_node& b) { return a.id < b.id; });
+        return nodes;
+    }
+
+    bool pin_current_thread(const std::vector<u32>& cpus) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        bool any = false;
+        for (u32 cpu : cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+                any = true;
+            }
+        }
+        return any && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    void set_current_thread_name(const std::string& name) {
+        // 内核限制线程名最多 15 个字符
+        pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+        tools::trace::set_thread_name(name);
+    }
+
+    i32 current_cpu() {
+        return sched_getcpu();
+    }
+#endif
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <string>
+#include <vector>
+
+namespace tools::thread {
+    // NUMA 节点及其 CPU 编号
+    struct numa_node {
+        u32 id = 0;
+        std::vector<u32> cpus;
+    };
+
+    // 读取 NUMA 拓扑（Linux 下来自 /sys/devices/system/node）
+    // 无法读取时返回包含全部 CPU 的单个节点
+    std::vector<numa_node> numa_topology();
+
+    // 将当前线程绑定到给定的 CPU 集合，成功返回 true
+    bool pin_current_thread(const std::vector<u32>& cpus);
+
+    // 设置当前线程名称，便于在 perf / top 与追踪视图中识别（Linux 下最多 15 个字符）
+    void set_current_thread_name(const std::string& name);
+
+    // 当前线程所在的 CPU 编号，不支持时返回 -1
+    i32 current_cpu();
+
+    // 解析 "0-3,8,10-11" 格式的 CPU 列表
+    std::vector<u32> parse_cpu_list(const std::string& text);
+}
@@ -0,0 +1,47 @@
+#include "coroutine.hpp"
+
+#include "timer.hpp"
+
+// 分级对象池
+#include "../memory/pool.hpp"
+
+#include <new>
+
+namespace tools::thread::coro {
+    namespace {
+        std::atomic<u64> heap_allocations{ 0 };
+        std::atomic<u64> heap_deallocations{ 0 };
+    }
+
+    void* frame_allocator::allocate(size_t size) {
+        if (tools::memory::size_class_pool::pooled(size)) {
+            return tools::memory::size_class_pool::allocate(size);
+        }
+        heap_allocations.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    void frame_allocator::deallocate(void* p, size_t size) noexcept {
+        if (tools::memory::size_class_pool::pooled(size)) {
+            tools::memory::size_class_pool::deallocate(p, size);
+            return;
+        }
+        heap_deallocations.fetch_add(1, std::memory_order_relaxed);
+        ::operator delete(p);
+    }
+
+    frame_allocator::statistics frame_allocator::stats() noexcept {
+        statistics result;
+        result.heap_allocations = heap_allocations.load(std::memory_order_relaxed);
+        result.heap_deallocations = heap_deallocations.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    namespace detail {
+        void schedule_timer(tools::time::time_point deadline, pool* workers, std::coroutine_handle<> handle) {
+            // 进程内共享的时间轮，到期后在目标线程池中恢复；线程池拒绝时在定时线程上恢复
+            static timer_wheel wheel;
+            wheel.schedule_at(*workers, deadline, [handle] { handle.resume(); });
+        }
+    }
+}
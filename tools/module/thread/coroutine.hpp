@@ -0,0 +1,364 @@
+#pragma once
+
+#include "../../base.hpp"
+
+// 线程池
+#include "pool.hpp"
+
+// 时间
+#include "../time/time.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace tools::thread::coro {
+    // 协程帧分配器：不超过 1 KiB 的帧取自 tools::memory::size_class_pool，更大的帧直接向系统申请
+    // 帧可以在其他线程释放，释放的内存进入释放线程的缓存
+    class frame_allocator {
+    public:
+        static void* allocate(size_t size);
+        static void deallocate(void* p, size_t size) noexcept;
+
+        // 统计信息
+        struct statistics {
+            // 超出分级池、直接向系统申请的次数（分级池自身的统计见 size_class_pool::stats）
+            u64 heap_allocations = 0;
+            // 直接归还系统的次数
+            u64 heap_deallocations = 0;
+        };
+        static statistics stats() noexcept;
+    };
+
+    template<typename T = void>
+    class task;
+
+    namespace detail {
+        // 协程承诺的公共部分：帧分配、延续与异常
+        struct promise_base {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr error;
+            // 等待方挂起完成与任务结束两者中后到达的一方负责恢复等待者
+            // 同步完成时等待者直接继续执行，不依赖尾调用，调试构建下栈深度也不会增长
+            std::atomic<bool> handoff{ false };
+
+            static void* operator new(size_t size) {
+                return frame_allocator::allocate(size);
+            }
+
+            static void operator delete(void* p, size_t size) noexcept {
+                frame_allocator::deallocate(p, size);
+            }
+
+            // 惰性启动：被 co_await 时才开始执行
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            // 结束时若等待方已挂起则恢复等待者
+            struct final_awaiter {
+                bool await_ready() noexcept {
+                    return false;
+                }
+
+                template<typename Promise>
+                void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+                    promise_base& p = h.promise();
+                    if (p.handoff.exchange(true, std::memory_order_acq_rel) && p.continuation) {
+                        p.continuation.resume();
+                    }
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            final_awaiter final_suspend() noexcept {
+                return {};
+            }
+
+            void unhandled_exception() noexcept {
+                error = std::current_exception();
+            }
+        };
+
+        template<typename T>
+        struct promise : promise_base {
+            std::optional<T> value;
+
+            task<T> get_return_object() noexcept;
+
+            template<typename U>
+            void return_value(U&& v) {
+                value.emplace(std::forward<U>(v));
+            }
+        };
+
+        template<>
+        struct promise<void> : promise_base {
+            task<void> get_return_object() noexcept;
+
+            void return_void() noexcept {}
+        };
+    }
+
+    // 惰性协程任务，只可移动；co_await 时启动并在完成后恢复等待者
+    // 每个任务只能被 co_await 一次
+    // 协程帧由 frame_allocator 分配
+    template<typename T>
+    class task {
+    public:
+        using promise_type = detail::promise<T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        task() noexcept = default;
+        explicit task(handle_type h) noexcept : handle(h) {}
+
+        task(task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+        task& operator=(task&& other) noexcept {
+            if (this != &other) {
+                if (handle) handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        task(const task&) = delete;
+        task& operator=(const task&) = delete;
+
+        ~task() {
+            if (handle) handle.destroy();
+        }
+
+        bool valid() const noexcept {
+            return static_cast<bool>(handle);
+        }
+
+        bool done() const noexcept {
+            return handle && handle.done();
+        }
+
+        auto operator co_await() && noexcept {
+            struct awaiter {
+                handle_type handle;
+
+                bool await_ready() const noexcept {
+                    return !handle || handle.done();
+                }
+
+                bool await_suspend(std::coroutine_handle<> waiting) noexcept {
+                    auto& p = handle.promise();
+                    p.continuation = waiting;
+                    handle.resume();
+                    // 任务已经结束则不挂起，直接继续执行
+                    return !p.handoff.exchange(true, std::memory_order_acq_rel);
+                }
+
+                T await_resume() {
+                    if (!handle) throw std::logic_error("task has no coroutine");
+                    auto& p = handle.promise();
+                    if (p.error) std::rethrow_exception(p.error);
+                    if constexpr (!std::is_void_v<T>) {
+                        return std::move(*p.value);
+                    }
+                }
+            };
+            return awaiter{ handle };
+        }
+
+    private:
+        handle_type handle = nullptr;
+    };
+
+    namespace detail {
+        template<typename T>
+        task<T> promise<T>::get_return_object() noexcept {
+            return task<T>(std::coroutine_handle<promise<T>>::from_promise(*this));
+        }
+
+        inline task<void> promise<void>::get_return_object() noexcept {
+            return task<void>(std::coroutine_handle<promise<void>>::from_promise(*this));
+        }
+
+        // 结束时挂起并通知的协程，用于 sync_wait
+        // 创建后先挂起，由等待方设置通知位置后再启动
+        struct blocking_task {
+            struct promise_type : promise_base {
+                std::atomic<bool>* finished = nullptr;
+
+                blocking_task get_return_object() noexcept {
+                    return blocking_task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+                }
+
+                // 挂起后再通知，等待方随后销毁协程帧是安全的
+                struct notify_awaiter {
+                    bool await_ready() noexcept {
+                        return false;
+                    }
+
+                    void await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                        std::atomic<bool>* finished = h.promise().finished;
+                        finished->store(true, std::memory_order_release);
+                        finished->notify_all();
+                    }
+
+                    void await_resume() noexcept {}
+                };
+
+                notify_awaiter final_suspend() noexcept {
+                    return {};
+                }
+
+                void return_void() noexcept {}
+            };
+
+            std::coroutine_handle<promise_type> handle;
+        };
+
+        // 立即开始、结束时自行销毁的协程，用于 spawn
+        struct detached_task {
+            struct promise_type : promise_base {
+                detached_task get_return_object() noexcept {
+                    return {};
+                }
+
+                std::suspend_never initial_suspend() noexcept {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() noexcept {
+                    return {};
+                }
+
+                void return_void() noexcept {}
+
+                // 分离的任务没有等待者，异常无处传递
+                void unhandled_exception() noexcept {
+                    std::terminate();
+                }
+            };
+        };
+
+        template<typename T>
+        blocking_task run_blocking(task<T>& t, std::optional<T>& result, std::exception_ptr& error) {
+            try {
+                result.emplace(co_await std::move(t));
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        inline blocking_task run_blocking(task<void>& t, std::exception_ptr& error) {
+            try {
+                co_await std::move(t);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        inline detached_task run_detached(task<void> t) {
+            co_await std::move(t);
+        }
+
+        // 启动协程，等待其结束并销毁帧
+        inline void finish_blocking(blocking_task runner) {
+            std::atomic<bool> finished{ false };
+            runner.handle.promise().finished = &finished;
+            runner.handle.resume();
+            while (!finished.load(std::memory_order_acquire)) {
+                finished.wait(false, std::memory_order_acquire);
+            }
+            runner.handle.destroy();
+        }
+    }
+
+    // 在当前线程阻塞等待任务完成并返回结果（任务中的异常在此重新抛出）
+    template<typename T>
+    T sync_wait(task<T> t) {
+        std::exception_ptr error;
+        if constexpr (std::is_void_v<T>) {
+            detail::finish_blocking(detail::run_blocking(t, error));
+            if (error) std::rethrow_exception(error);
+        }
+        else {
+            std::optional<T> result;
+            detail::finish_blocking(detail::run_blocking(t, result, error));
+            if (error) std::rethrow_exception(error);
+            return std::move(*result);
+        }
+    }
+
+    // 启动一个分离的任务，不等待结果（任务抛出异常将终止程序）
+    inline void spawn(task<void> t) {
+        detail::run_detached(std::move(t));
+    }
+
+    // 转移到线程池执行：co_await schedule(pool) 之后的代码在工作线程上运行
+    // 线程池已停止时在当前线程继续
+    class schedule_awaiter {
+    public:
+        schedule_awaiter(pool& workers, priority lane) noexcept : workers(workers), lane(lane) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            return workers.insert_to(lane, [h] { h.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        pool& workers;
+        priority lane;
+    };
+
+    inline schedule_awaiter schedule(pool& workers, priority lane = priority::normal) noexcept {
+        return schedule_awaiter(workers, lane);
+    }
+
+    namespace detail {
+        // 到期后在线程池中恢复 handle，由共享的时间轮驱动
+        void schedule_timer(tools::time::time_point deadline, pool* workers, std::coroutine_handle<> handle);
+    }
+
+    // 定时器：到达 deadline 后在线程池中恢复
+    class timer_awaiter {
+    public:
+        timer_awaiter(pool& workers, tools::time::time_point deadline) noexcept
+            : workers(workers), deadline(deadline) {}
+
+        bool await_ready() const noexcept {
+            return tools::time::time_now() >= deadline;
+        }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            detail::schedule_timer(deadline, &workers, h);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        pool& workers;
+        tools::time::time_point deadline;
+    };
+
+    inline timer_awaiter sleep_until(pool& workers, tools::time::time_point deadline) noexcept {
+        return timer_awaiter(workers, deadline);
+    }
+
+    template<typename Rep, typename Period>
+    timer_awaiter sleep_for(pool& workers, std::chrono::duration<Rep, Period> duration) noexcept {
+        return timer_awaiter(workers, tools::time::time_now() +
+            std::chrono::duration_cast<tools::time::time_point::duration>(duration));
+    }
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace tools::thread {
+    namespace detail {
+        // 单值计数器的分片，独占一个缓存行
+        struct alignas(64) value_cell {
+            std::atomic<u64> value{ 0 };
+        };
+
+        // 进行中计数的分片，独占一个缓存行
+        struct alignas(64) counter_cell {
+            std::atomic<u64> started{ 0 };
+            std::atomic<u64> finished{ 0 };
+        };
+
+        // 默认分片数：不小于硬件线程数的 2 的幂，最多 64
+        inline u64 default_counter_cells() noexcept {
+            u64 hw = std::max<u64>(1, std::thread::hardware_concurrency());
+            u64 cells = 1;
+            while (cells < hw && cells < 64) cells <<= 1;
+            return cells;
+        }
+
+        // 当前线程使用的分片编号：线程首次使用时轮流分配，之后固定
+        inline u64 counter_slot() noexcept {
+            static std::atomic<u64> next{ 0 };
+            thread_local u64 slot = next.fetch_add(1, std::memory_order_relaxed);
+            return slot;
+        }
+    }
+
+    // 分片计数器：各线程累加到自己的分片（独占缓存行），读取时求和
+    // 写入不在线程之间争抢同一缓存行，读取代价与分片数成正比，适合写多读少的统计
+    class sharded_counter {
+    public:
+        // cells：分片数（取 2 的幂），0 表示按硬件线程数
+        explicit sharded_counter(u64 cells = 0) {
+            u64 count = 1;
+            u64 wanted = cells ? cells : detail::default_counter_cells();
+            while (count < wanted) count <<= 1;
+            this->cells.reset(new detail::value_cell[count]);
+            mask = count - 1;
+        }
+
+        sharded_counter(const sharded_counter&) = delete;
+        sharded_counter& operator=(const sharded_counter&) = delete;
+
+        void add(u64 n = 1, std::memory_order order = std::memory_order_relaxed) noexcept {
+            cells[detail::counter_slot() & mask].value.fetch_add(n, order);
+        }
+
+        // 各分片之和（不是某一时刻的精确快照）
+        u64 value(std::memory_order order = std::memory_order_relaxed) const noexcept {
+            u64 total = 0;
+            for (u64 i = 0; i <= mask; ++i) total += cells[i].value.load(order);
+            return total;
+        }
+
+        // 导出用的当前值
+        u64 snapshot() const noexcept {
+            return value();
+        }
+
+        u64 cell_count() const noexcept {
+            return mask + 1;
+        }
+
+    private:
+        std::unique_ptr<detail::value_cell[]> cells;
+        u64 mask = 0;
+    };
+
+    // 进行中数量的快照
+    struct inflight_snapshot {
+        // 累计开始数
+        u64 started = 0;
+        // 累计完成数
+        u64 finished = 0;
+        // 进行中的数量
+        u64 pending = 0;
+    };
+
+    // 分片的进行中计数（如待执行任务数、队列长度）
+    // 开始与完成分别单调累加，读取时先读完成数、再读开始数：
+    // 每个被计入的完成都先行于对应的开始，所以结果不会为负，
+    // 为 0 时读取过程中确有一刻没有进行中的项（不会因分片读取先后而误报为 0）
+    // 完成以 release 写入、读取以 acquire 读取时上述保证成立
+    class inflight_counter {
+    public:
+        explicit inflight_counter(u64 cells = 0) {
+            u64 count = 1;
+            u64 wanted = cells ? cells : detail::default_counter_cells();
+            while (count < wanted) count <<= 1;
+            this->cells.reset(new detail::counter_cell[count]);
+            mask = count - 1;
+        }
+
+        inflight_counter(const inflight_counter&) = delete;
+        inflight_counter& operator=(const inflight_counter&) = delete;
+
+        void begin(u64 n = 1, std::memory_order order = std::memory_order_relaxed) noexcept {
+            cells[detail::counter_slot() & mask].started.fetch_add(n, order);
+        }
+
+        void end(u64 n = 1, std::memory_order order = std::memory_order_release) noexcept {
+            cells[detail::counter_slot() & mask].finished.fetch_add(n, order);
+        }
+
+        // 进行中的数量
+        u64 pending(std::memory_order order = std::memory_order_acquire) const noexcept {
+            return snapshot(order).pending;
+        }
+
+        bool idle(std::memory_order order = std::memory_order_acquire) const noexcept {
+            return pending(order) == 0;
+        }
+
+        inflight_snapshot snapshot(std::memory_order order = std::memory_order_acquire) const noexcept {
+            inflight_snapshot s;
+            for (u64 i = 0; i <= mask; ++i) s.finished += cells[i].finished.load(order);
+            for (u64 i = 0; i <= mask; ++i) s.started += cells[i].started.load(order);
+            s.pending = s.started > s.finished ? s.started - s.finished : 0;
+            return s;
+        }
+
+        u64 cell_count() const noexcept {
+            return mask + 1;
+        }
+
+    private:
+        std::unique_ptr<detail::counter_cell[]> cells;
+        u64 mask = 0;
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <atomic>
+
+namespace tools::thread {
+    // 事件计数器（eventcount）
+    // 等待方先 prepare_wait() 登记并取得当前纪元，再检查条件，
+    // 条件仍不满足时 commit_wait() 阻塞，满足时 cancel_wait() 撤销登记；
+    // 通知方修改条件后调用 notify_one()/notify_all()，无等待者时只有一次内存屏障和读取
+    // 阻塞基于 std::atomic::wait（Linux 上为 futex）
+    class event_count {
+    public:
+        using key = u32;
+
+        event_count() = default;
+        event_count(const event_count&) = delete;
+        event_count& operator=(const event_count&) = delete;
+
+        // 登记为等待者并返回当前纪元
+        key prepare_wait() noexcept {
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return epoch.load(std::memory_order_acquire);
+        }
+
+        // 撤销登记
+        void cancel_wait() noexcept {
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // 阻塞直到纪元发生变化
+        void commit_wait(key k) noexcept {
+            while (epoch.load(std::memory_order_acquire) == k) {
+                epoch.wait(k, std::memory_order_acquire);
+            }
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // 唤醒一个等待者
+        void notify_one() noexcept {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed) != 0) {
+                epoch.fetch_add(1, std::memory_order_release);
+                epoch.notify_one();
+            }
+        }
+
+        // 唤醒所有等待者
+        void notify_all() noexcept {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed) != 0) {
+                epoch.fetch_add(1, std::memory_order_release);
+                epoch.notify_all();
+            }
+        }
+
+        // 与 notify_all() 相同，但省去屏障：调用方刚执行过 seq_cst 屏障（如另一个 event_count 的通知）
+        void notify_all_after_fence() noexcept {
+            if (waiters.load(std::memory_order_relaxed) != 0) {
+                epoch.fetch_add(1, std::memory_order_release);
+                epoch.notify_all();
+            }
+        }
+
+        // 当前等待者数量
+        u32 waiting() const noexcept {
+            return waiters.load(std::memory_order_relaxed);
+        }
+
+    private:
+        alignas(64) std::atomic<u32> epoch{ 0 };
+        alignas(64) std::atomic<u32> waiters{ 0 };
+    };
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tools::thread {
+    template<typename T>
+    class future;
+
+    namespace detail {
+        // 共享状态基类：引用计数 + 完成标志 + 单个完成回调
+        // 等待通过 std::atomic::wait 阻塞，不自旋
+        class state_base {
+        public:
+            explicit state_base(u32 initial_refs) noexcept : refs(initial_refs) {}
+            virtual ~state_base() = default;
+
+            state_base(const state_base&) = delete;
+            state_base& operator=(const state_base&) = delete;
+
+            void retain() noexcept {
+                refs.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void release() noexcept {
+                if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete this;
+                }
+            }
+
+            bool ready() const noexcept {
+                return status.load(std::memory_order_acquire) == status_ready;
+            }
+
+            // 阻塞等待完成
+            void wait() const noexcept {
+                u32 current = status.load(std::memory_order_acquire);
+                while (current != status_ready) {
+                    status.wait(current, std::memory_order_acquire);
+                    current = status.load(std::memory_order_acquire);
+                }
+            }
+
+            // 注册完成回调，若已完成则立即在当前线程调用
+            // 每个共享状态只能注册一次：先占住注册权再写入回调，重复注册不会覆盖已登记的回调
+            void on_ready(void (*callback)(void*), void* context) {
+                u32 expected = status_pending;
+                if (!status.compare_exchange_strong(
+                    expected, status_registering,
+                    std::memory_order_acquire,
+                    std::memory_order_acquire)) {
+                    if (expected != status_ready) {
+                        throw std::logic_error("future already has a continuation");
+                    }
+                    callback(context);
+                    return;
+                }
+                callback_ = callback;
+                context_ = context;
+                // 写入回调期间已完成时 finish() 不会调用回调，由注册方调用
+                expected = status_registering;
+                if (!status.compare_exchange_strong(
+                    expected, status_callback,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+                    callback(context);
+                }
+            }
+
+            // 以异常结束
+            void fail(std::exception_ptr e) noexcept {
+                error = std::move(e);
+                finish();
+            }
+
+        protected:
+            // 标记完成并唤醒等待者
+            void finish() noexcept {
+                u32 old = status.exchange(status_ready, std::memory_order_acq_rel);
+                if (old == status_callback) {
+                    callback_(context_);
+                }
+                status.notify_all();
+            }
+
+            template<typename>
+            friend class tools::thread::future;
+
+            std::exception_ptr error;
+
+        private:
+            static constexpr u32 status_pending = 0;
+            static constexpr u32 status_ready = 1;
+            static constexpr u32 status_callback = 2;
+            // 正在写入回调
+            static constexpr u32 status_registering = 3;
+
+            std::atomic<u32> refs;
+            std::atomic<u32> status{ status_pending };
+            void (*callback_)(void*) = nullptr;
+            void* context_ = nullptr;
+        };
+
+        // 带结果的共享状态
+        template<typename T>
+        class shared_state : public state_base {
+        public:
+            using state_base::state_base;
+
+            template<typename... Args>
+            void set_value(Args&&... args) {
+                value.emplace(std::forward<Args>(args)...);
+                finish();
+            }
+
+            std::optional<T> value;
+        };
+
+        template<>
+        class shared_state<void> : public state_base {
+        public:
+            using state_base::state_base;
+
+            void set_value() noexcept {
+                finish();
+            }
+        };
+
+        // 任务状态：可调用对象与结果存放在同一次分配中
+        // 初始引用计数为 2，一份属于 future，一份属于待执行的任务
+        template<typename T, typename F>
+        class task_state final : public shared_state<T> {
+        public:
+            explicit task_state(F&& func) : shared_state<T>(2), func(std::move(func)) {}
+
+            // 执行任务并释放任务持有的引用
+            void run() noexcept {
+                try {
+                    if constexpr (std::is_void_v<T>) {
+                        func();
+                        this->set_value();
+                    }
+                    else {
+                        this->set_value(func());
+                    }
+                }
+                catch (...) {
+                    this->fail(std::current_exception());
+                }
+                this->release();
+            }
+
+        private:
+            F func;
+        };
+
+        // 队列中的任务持有者：执行时转交引用；未执行就被丢弃（如线程池被 join()）时以异常结束
+        template<typename State>
+        class task_runner {
+        public:
+            explicit task_runner(State state) noexcept : state(state) {}
+
+            task_runner(task_runner&& other) noexcept : state(std::exchange(other.state, nullptr)) {}
+            task_runner& operator=(task_runner&&) = delete;
+
+            ~task_runner() {
+                if (state) {
+                    state->fail(std::make_exception_ptr(std::runtime_error("task was discarded")));
+                    state->release();
+                }
+            }
+
+            void operator()() noexcept {
+                std::exchange(state, nullptr)->run();
+            }
+
+        private:
+            State state;
+        };
+
+        // when_all 的汇总状态
+        class all_state final : public shared_state<void> {
+        public:
+            // 引用：一份属于返回的 future，一份属于尚未完成的批次
+            explicit all_state(u64 count) : shared_state<void>(2), remaining(count + 1) {}
+
+            static void arrive(void* context) noexcept {
+                auto* self = static_cast<all_state*>(context);
+                if (self->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    self->set_value();
+                    self->release();
+                }
+            }
+
+        private:
+            std::atomic<u64> remaining;
+        };
+    }
+
+    // 轻量 future：持有任务结果或异常
+    template<typename T>
+    class future {
+    public:
+        future() noexcept = default;
+
+        // 接管一份共享状态的引用
+        explicit future(detail::shared_state<T>* state) noexcept : state(state) {}
+
+        future(future&& other) noexcept : state(std::exchange(other.state, nullptr)) {}
+
+        future& operator=(future&& other) noexcept {
+            if (this != &other) {
+                reset();
+                state = std::exchange(other.state, nullptr);
+            }
+            return *this;
+        }
+
+        future(const future&) = delete;
+        future& operator=(const future&) = delete;
+
+        ~future() {
+            reset();
+        }
+
+        // 是否关联共享状态
+        bool valid() const noexcept {
+            return state != nullptr;
+        }
+
+        // 是否已完成
+        bool ready() const noexcept {
+            return state && state->ready();
+        }
+
+        // 阻塞等待完成
+        void wait() const {
+            if (!state) throw std::logic_error("future has no state");
+            state->wait();
+        }
+
+        // 等待并获取结果，任务抛出的异常在此重新抛出
+        // 非 void 结果只能取出一次
+        T get() {
+            wait();
+            if (state->error) {
+                std::rethrow_exception(state->error);
+            }
+            if constexpr (!std::is_void_v<T>) {
+                return std::move(*state->value);
+            }
+        }
+
+        // 注册完成回调（仅一次），供 when_all 等组合使用
+        void on_ready(void (*callback)(void*), void* context) {
+            if (!state) throw std::logic_error("future has no state");
+            state->on_ready(callback, context);
+        }
+
+    private:
+        void reset() noexcept {
+            if (state) {
+                state->release();
+                state = nullptr;
+            }
+        }
+
+        detail::shared_state<T>* state = nullptr;
+    };
+
+    // 等待一批 future 全部完成，返回的 future 在最后一个完成时就绪
+    // 结果仍从原来的 future 中获取；每个 future 只能参与一次 when_all
+    template<typename T>
+    future<void> when_all(std::vector<future<T>>& futures) {
+        auto* state = new detail::all_state(futures.size());
+        future<void> result(state);
+        for (auto& f : futures) {
+            f.on_ready(&detail::all_state::arrive, state);
+        }
+        detail::all_state::arrive(state);
+        return result;
+    }
+
+    template<typename... Ts>
+    future<void> when_all(future<Ts>&... futures) {
+        auto* state = new detail::all_state(sizeof...(Ts));
+        future<void> result(state);
+        (futures.on_ready(&detail::all_state::arrive, state), ...);
+        detail::all_state::arrive(state);
+        return result;
+    }
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "../../base.hpp"
+
+// 内存回收
+#include "reclaim.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace tools::thread {
+    // 节点池统计信息
+    struct node_pool_stats {
+        // 向系统申请内存的次数
+        u64 heap_allocations = 0;
+        // 向系统申请的总字节数
+        u64 heap_bytes = 0;
+        // 已创建的节点槽位总数（含预分配）
+        u64 total_nodes = 0;
+        // 线程缓存归还到全局空闲链表的批次数
+        u64 batches_released = 0;
+        // 线程缓存从全局空闲链表取回的批次数
+        u64 batches_acquired = 0;
+    };
+
+    // 无锁容器的节点池（每个节点类型一个全局实例）
+    // 每个线程持有本地缓存，缓存耗尽时从全局空闲链表整批取回，过多时整批归还；
+    // 全局链表也为空时一次申请一整块（chunk_nodes 个）槽位
+    // 全局链表入链无锁；出链只在缓存耗尽时发生，用一个标志串行化以避免 ABA 问题
+    template<typename T>
+    class node_pool {
+    private:
+        // 空闲槽位：复用节点内存存放链表指针
+        struct free_slot {
+            free_slot* next;        // 批次内下一个槽位
+            free_slot* next_batch;  // 全局链表中下一个批次（仅批次首个槽位有效）
+            u64 count;              // 批次内槽位数（仅批次首个槽位有效）
+        };
+
+        static constexpr size_t slot_size = std::max(sizeof(T), sizeof(free_slot));
+        static constexpr size_t slot_align = std::max(alignof(T), alignof(free_slot));
+        static constexpr size_t slot_stride = (slot_size + slot_align - 1) / slot_align * slot_align;
+
+        // 每次向系统申请的槽位数
+        static constexpr u64 chunk_nodes = 64;
+        // 线程缓存上限，超过时归还一半
+        static constexpr u64 cache_limit = 256;
+
+        // 线程本地缓存，可平凡析构，线程退出后仍可安全访问
+        struct local_cache {
+            free_slot* head = nullptr;
+            u64 count = 0;
+            bool dead = false;
+        };
+
+        // 线程退出时把缓存归还全局链表
+        struct cache_owner {
+            ~cache_owner() {
+                local_cache& cache = node_pool::cache();
+                node_pool::instance().release_batch(cache.head, cache.count);
+                cache.head = nullptr;
+                cache.count = 0;
+                cache.dead = true;
+            }
+        };
+
+        static local_cache& cache() noexcept {
+            static thread_local local_cache local;
+            return local;
+        }
+
+        static local_cache& owned_cache() noexcept {
+            static thread_local cache_owner owner;
+            (void)owner;
+            return cache();
+        }
+
+        alignas(64) std::atomic<free_slot*> batches{ nullptr };
+        std::atomic<bool> popping{ false };
+        alignas(64) std::atomic<u64> heap_allocations{ 0 };
+        std::atomic<u64> heap_bytes{ 0 };
+        std::atomic<u64> total_nodes{ 0 };
+        std::atomic<u64> batches_released{ 0 };
+        std::atomic<u64> batches_acquired{ 0 };
+
+        node_pool() = default;
+
+        // 申请一块包含 n 个槽位的内存，串成一个批次（内存不归还系统）
+        free_slot* allocate_chunk(u64 n) {
+            void* raw;
+            if constexpr (slot_align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                raw = ::operator new(slot_stride * n, std::align_val_t(slot_align));
+            }
+            else {
+                raw = ::operator new(slot_stride * n);
+            }
+            auto* memory = static_cast<std::byte*>(raw);
+            heap_allocations.fetch_add(1, std::memory_order_relaxed);
+            heap_bytes.fetch_add(slot_stride * n, std::memory_order_relaxed);
+            total_nodes.fetch_add(n, std::memory_order_relaxed);
+
+            free_slot* head = nullptr;
+            for (u64 i = n; i > 0; --i) {
+                auto* slot = reinterpret_cast<free_slot*>(memory + slot_stride * (i - 1));
+                slot->next = head;
+                head = slot;
+            }
+            head->count = n;
+            return head;
+        }
+
+        // 把一串槽位作为一个批次压入全局链表
+        void release_batch(free_slot* head, u64 count) noexcept {
+            if (!head) return;
+            head->count = count;
+            free_slot* top = batches.load(std::memory_order_relaxed);
+            do {
+                head->next_batch = top;
+            } while (!batches.compare_exchange_weak(
+                top, head,
+                std::memory_order_release,
+                std::memory_order_relaxed));
+            batches_released.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // 从全局链表取出一个批次
+        // 同一时刻只有一个线程出链，栈顶批次在 CAS 之前不会被取走再放回
+        free_slot* acquire_batch() noexcept {
+            if (!batches.load(std::memory_order_relaxed)) return nullptr;
+            while (popping.exchange(true, std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            free_slot* top = batches.load(std::memory_order_acquire);
+            while (top && !batches.compare_exchange_weak(
+                top, top->next_batch,
+                std::memory_order_acquire,
+                std::memory_order_acquire)) {
+            }
+            popping.store(false, std::memory_order_release);
+            if (top) batches_acquired.fetch_add(1, std::memory_order_relaxed);
+            return top;
+        }
+
+        void* allocate() {
+            local_cache& local = owned_cache();
+            if (!local.head) {
+                free_slot* batch = acquire_batch();
+                if (!batch) batch = allocate_chunk(chunk_nodes);
+                local.head = batch;
+                local.count = batch->count;
+            }
+            free_slot* slot = local.head;
+            local.head = slot->next;
+            --local.count;
+            return slot;
+        }
+
+        void deallocate(void* p) noexcept {
+            auto* slot = static_cast<free_slot*>(p);
+
+            // 线程已退出（如进程结束时的回收），直接归还全局链表
+            if (cache().dead) {
+                slot->next = nullptr;
+                release_batch(slot, 1);
+                return;
+            }
+
+            local_cache& local = owned_cache();
+            slot->next = local.head;
+            local.head = slot;
+            if (++local.count > cache_limit) {
+                // 归还一半
+                u64 keep = cache_limit / 2;
+                free_slot* tail = local.head;
+                for (u64 i = 1; i < keep; ++i) tail = tail->next;
+                free_slot* batch = tail->next;
+                tail->next = nullptr;
+                release_batch(batch, local.count - keep);
+                local.count = keep;
+            }
+        }
+
+        static void recycle(void* p) noexcept {
+            static_cast<T*>(p)->~T();
+            instance().deallocate(p);
+        }
+
+    public:
+        static node_pool& instance() {
+            static node_pool pool;
+            return pool;
+        }
+
+        node_pool(const node_pool&) = delete;
+        node_pool& operator=(const node_pool&) = delete;
+
+        // 从池中构造节点
+        template<typename... Args>
+        T* create(Args&&... args) {
+            void* p = allocate();
+            try {
+                return ::new (p) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                deallocate(p);
+                throw;
+            }
+        }
+
+        // 立即销毁节点（调用方保证没有其他线程引用）
+        void destroy(T* p) noexcept {
+            if (p) recycle(p);
+        }
+
+        // 延迟销毁节点，待所有线程离开临界区后回到池中
+        void retire(T* p) {
+            reclaim::retire(static_cast<void*>(p), &node_pool::recycle);
+        }
+
+        // 一次预分配 n 个槽位（一整块内存），分批放入全局链表，避免运行时向系统申请
+        void reserve(u64 n) {
+            if (n == 0) return;
+            free_slot* slot = allocate_chunk(n);
+            while (slot) {
+                free_slot* head = slot;
+                u64 count = 1;
+                while (count < cache_limit / 2 && slot->next) {
+                    slot = slot->next;
+                    ++count;
+                }
+                free_slot* rest = slot->next;
+                slot->next = nullptr;
+                release_batch(head, count);
+                slot = rest;
+            }
+        }
+
+        node_pool_stats stats() const noexcept {
+            node_pool_stats s;
+            s.heap_allocations = heap_allocations.load(std::memory_order_relaxed);
+            s.heap_bytes = heap_bytes.load(std::memory_order_relaxed);
+            s.total_nodes = total_nodes.load(std::memory_order_relaxed);
+            s.batches_released = batches_released.load(std::memory_order_relaxed);
+            s.batches_acquired = batches_acquired.load(std::memory_order_relaxed);
+            return s;
+        }
+    };
+}
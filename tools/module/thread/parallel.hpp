@@ -0,0 +1,296 @@
+#pragma once
+
+#include "../../base.hpp"
+
+// 线程池
+#include "pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tools::thread {
+    // 阻塞式数据并行算法
+    // 在已有线程池上运行，调用线程同样参与计算；返回后线程池可继续使用
+    // 区间按自适应粒度（剩余量 / 参与线程数，不小于 grain）动态认领，负载不均时自动平衡
+
+    namespace detail {
+        // 一次并行调用的共享状态
+        // 由调用线程与提交到线程池的辅助任务共同持有，调用返回后迟到的辅助任务仍可安全访问
+        class range_state {
+        public:
+            range_state(u64 total, u64 grain, u64 workers) noexcept
+                : total(total), grain(grain), workers(workers) {}
+
+            // 认领一段 [begin, end)，区间已分完时返回 false
+            bool claim(u64& begin, u64& end) noexcept {
+                u64 current = next.load(std::memory_order_relaxed);
+                while (current < total) {
+                    u64 remaining = total - current;
+                    u64 size = std::min(remaining, std::max(grain, remaining / (2 * workers)));
+                    if (next.compare_exchange_weak(
+                        current, current + size,
+                        std::memory_order_relaxed,
+                        std::memory_order_relaxed)) {
+                        begin = current;
+                        end = current + size;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // 辅助任务加入计算；区间已分完时不再加入（此后不会访问调用方的数据）
+            bool enter() noexcept {
+                active.fetch_add(1, std::memory_order_acq_rel);
+                if (next.load(std::memory_order_acquire) >= total) {
+                    leave();
+                    return false;
+                }
+                return true;
+            }
+
+            void leave() noexcept {
+                if (active.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    active.notify_all();
+                }
+            }
+
+            // 等待所有已加入的线程处理完各自认领的区间
+            void wait() noexcept {
+                u32 current = active.load(std::memory_order_acquire);
+                while (current != 0) {
+                    active.wait(current, std::memory_order_acquire);
+                    current = active.load(std::memory_order_acquire);
+                }
+            }
+
+            // 循环认领区间并执行 body(begin, end)
+            // 出现异常后不再执行剩余区间，只记录第一个异常
+            template<typename Body>
+            void drain(Body& body) noexcept {
+                u64 begin, end;
+                while (claim(begin, end)) {
+                    if (failed.load(std::memory_order_relaxed)) continue;
+                    try {
+                        body(begin, end);
+                    }
+                    catch (...) {
+                        fail(std::current_exception());
+                    }
+                }
+            }
+
+            void fail(std::exception_ptr e) noexcept {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::move(e);
+                failed.store(true, std::memory_order_relaxed);
+            }
+
+            // 在调用线程重新抛出计算中的异常
+            void rethrow() {
+                if (error) std::rethrow_exception(error);
+            }
+
+        private:
+            alignas(64) std::atomic<u64> next{ 0 };
+            alignas(64) std::atomic<u32> active{ 1 };  // 调用线程本身
+            std::atomic<bool> failed{ false };
+            u64 total;
+            u64 grain;
+            u64 workers;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+        };
+
+        // 在 [0, total) 上并行执行 participant(state)，调用线程参与并等待全部完成
+        template<typename Participant>
+        void run_parallel(pool& workers, u64 total, u64 grain, Participant& participant) {
+            if (total == 0) return;
+
+            u64 threads = workers.thread_count();
+            if (grain == 0) {
+                // 默认粒度：每个参与线程约 64 段
+                grain = std::max<u64>(1, total / ((threads + 1) * 64));
+            }
+            auto state = std::make_shared<range_state>(total, grain, threads + 1);
+
+            // 只有一段时调用线程直接完成
+            u64 helpers = std::min(threads, (total + grain - 1) / grain - 1);
+            for (u64 i = 0; i < helpers; ++i) {
+                bool posted = workers.insert([state, &participant] {
+                    if (state->enter()) {
+                        participant(*state);
+                        state->leave();
+                    }
+                });
+                // 线程池已停止时由调用线程完成全部计算
+                if (!posted) break;
+            }
+
+            participant(*state);
+            state->leave();
+            state->wait();
+            state->rethrow();
+        }
+    }
+
+    // 并行执行 body(begin, end)，各段互不重叠且覆盖 [first, last)
+    // grain 为每段的最小长度，0 表示自动选择
+    template<typename Index, typename Body>
+    void parallel_for(pool& workers, Index first, Index last, Body&& body, Index grain = 0) {
+        static_assert(std::is_integral_v<Index>, "parallel_for requires an integral index type.");
+        if (!(first < last)) return;
+
+        auto chunk = [&](u64 begin, u64 end) {
+            body(static_cast<Index>(first + static_cast<Index>(begin)),
+                static_cast<Index>(first + static_cast<Index>(end)));
+        };
+        auto participant = [&](detail::range_state& state) {
+            state.drain(chunk);
+        };
+        detail::run_parallel(workers,
+            static_cast<u64>(last - first), static_cast<u64>(grain), participant);
+    }
+
+    // 并行归约：每个线程以 identity 为初值，依次 value = body(begin, end, value) 累积各段，
+    // 最后用 combine 合并各线程的结果
+    // combine 需满足结合律与交换律
+    template<typename Index, typename T, typename Body, typename Combine>
+    T parallel_reduce(pool& workers, Index first, Index last, T identity,
+        Body&& body, Combine&& combine, Index grain = 0) {
+        static_assert(std::is_integral_v<Index>, "parallel_reduce requires an integral index type.");
+        if (!(first < last)) return identity;
+
+        T result = identity;
+        std::mutex result_mutex;
+
+        auto participant = [&](detail::range_state& state) {
+            // 认领到区间后才访问 identity，迟到的辅助任务不会触碰调用方的数据
+            std::optional<T> local;
+            auto chunk = [&](u64 begin, u64 end) {
+                if (!local) local.emplace(identity);
+                local = body(static_cast<Index>(first + static_cast<Index>(begin)),
+                    static_cast<Index>(first + static_cast<Index>(end)),
+                    std::move(*local));
+            };
+            state.drain(chunk);
+            if (local) {
+                std::lock_guard<std::mutex> lock(result_mutex);
+                result = combine(std::move(result), std::move(*local));
+            }
+        };
+        detail::run_parallel(workers,
+            static_cast<u64>(last - first), static_cast<u64>(grain), participant);
+        return result;
+    }
+
+    // 并行变换：out[i] = func(first[i])，要求随机访问迭代器
+    template<typename InputIt, typename OutputIt, typename Func>
+    OutputIt parallel_transform(pool& workers, InputIt first, InputIt last, OutputIt out, Func&& func) {
+        using diff = typename std::iterator_traits<InputIt>::difference_type;
+        diff n = last - first;
+        parallel_for(workers, diff(0), n, [&](diff begin, diff end) {
+            std::transform(first + begin, first + end, out + begin, func);
+        });
+        return out + n;
+    }
+
+    namespace detail {
+        // 并行合并两个相邻的有序区间 [a, a_end)、[b, b_end) 到 out
+        // 按左区间切分，右区间用 lower_bound 找到对应位置，相等元素左区间在前
+        template<typename It, typename OutIt, typename Compare>
+        void parallel_merge(pool& workers, It a, It a_end, It b, It b_end, OutIt out,
+            Compare& comp, std::ptrdiff_t grain) {
+            std::ptrdiff_t n = a_end - a;
+            if (n == 0) {
+                std::move(b, b_end, out);
+                return;
+            }
+            std::ptrdiff_t pieces = std::max<std::ptrdiff_t>(1, n / grain);
+            // 先算出全部切分点，合并时元素会被移走
+            std::vector<It> splits(static_cast<size_t>(pieces + 1));
+            splits[0] = b;
+            splits[static_cast<size_t>(pieces)] = b_end;
+            for (std::ptrdiff_t k = 1; k < pieces; ++k) {
+                splits[static_cast<size_t>(k)] = std::lower_bound(b, b_end, *(a + n * k / pieces), comp);
+            }
+            parallel_for(workers, std::ptrdiff_t(0), pieces, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                for (std::ptrdiff_t k = begin; k < end; ++k) {
+                    It a_lo = a + n * k / pieces;
+                    It a_hi = a + n * (k + 1) / pieces;
+                    It b_lo = splits[static_cast<size_t>(k)];
+                    It b_hi = splits[static_cast<size_t>(k + 1)];
+                    std::merge(std::make_move_iterator(a_lo), std::make_move_iterator(a_hi),
+                        std::make_move_iterator(b_lo), std::make_move_iterator(b_hi),
+                        out + ((a_lo - a) + (b_lo - b)), comp);
+                }
+            }, std::ptrdiff_t(1));
+        }
+    }
+
+    // 并行归并排序（不稳定）：各块并行 std::sort，再逐轮两两并行合并
+    // 元素需可默认构造与移动赋值
+    template<typename RandomIt, typename Compare = std::less<>>
+    void parallel_sort(pool& workers, RandomIt first, RandomIt last, Compare comp = Compare()) {
+        using value_type = typename std::iterator_traits<RandomIt>::value_type;
+        constexpr std::ptrdiff_t sequential_threshold = 1 << 14;
+
+        std::ptrdiff_t n = last - first;
+        if (n <= sequential_threshold) {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        // 块数取不小于参与线程数的 2 的幂
+        std::ptrdiff_t blocks = 1;
+        while (blocks < static_cast<std::ptrdiff_t>(workers.thread_count() + 1)) blocks <<= 1;
+        blocks = std::min(blocks, n / (sequential_threshold / 4));
+        if (blocks <= 1) {
+            std::sort(first, last, comp);
+            return;
+        }
+        auto bound = [&](std::ptrdiff_t block) { return n * block / blocks; };
+
+        parallel_for(workers, std::ptrdiff_t(0), blocks, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            for (std::ptrdiff_t k = begin; k < end; ++k) {
+                std::sort(first + bound(k), first + bound(k + 1), comp);
+            }
+        }, std::ptrdiff_t(1));
+
+        // 在原区间与缓冲区之间交替合并
+        std::vector<value_type> buffer(static_cast<size_t>(n));
+        const std::ptrdiff_t merge_grain = std::max<std::ptrdiff_t>(sequential_threshold / 4, n / (blocks * 4));
+        bool in_buffer = false;
+        for (std::ptrdiff_t width = 1; width < blocks; width <<= 1) {
+            for (std::ptrdiff_t k = 0; k < blocks; k += 2 * width) {
+                std::ptrdiff_t lo = bound(k);
+                std::ptrdiff_t mid = bound(std::min(k + width, blocks));
+                std::ptrdiff_t hi = bound(std::min(k + 2 * width, blocks));
+                if (in_buffer) {
+                    detail::parallel_merge(workers, buffer.begin() + lo, buffer.begin() + mid,
+                        buffer.begin() + mid, buffer.begin() + hi, first + lo, comp, merge_grain);
+                }
+                else {
+                    detail::parallel_merge(workers, first + lo, first + mid,
+                        first + mid, first + hi, buffer.begin() + lo, comp, merge_grain);
+                }
+            }
+            in_buffer = !in_buffer;
+        }
+
+        if (in_buffer) {
+            parallel_for(workers, std::ptrdiff_t(0), n, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                std::move(buffer.begin() + begin, buffer.begin() + end, first + begin);
+            });
+        }
+    }
+}
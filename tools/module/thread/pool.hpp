@@ -5,51 +5,278 @@
 // 多线程数据容器
 #include "thread_data.hpp"
 
+// 任务类型
+#include "task.hpp"
+
+// 任务结果
+#include "future.hpp"
+
+// 空闲线程休眠/唤醒
+#include "event_count.hpp"
+
+// 分片计数器
+#include "counter.hpp"
+
+// 时间
+#include "../time/time.hpp"
+
+// 延迟直方图
+#include "../time/histogram.hpp"
+
+// CPU 绑定与线程命名
+#include "affinity.hpp"
+
+// 事件追踪
+#include "../trace/trace.hpp"
+
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <thread>
 #include <atomic>
 #include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 namespace tools::thread {
+    // 调度模式
+    enum class schedule_mode {
+        // 共享队列：所有线程竞争同一个任务队列
+        shared_queue,
+        // 工作窃取：每个线程一个本地双端队列，空闲时随机窃取其他线程的任务
+        work_stealing,
+    };
+
+    // 共享任务队列的存储方式
+    enum class queue_backend {
+        // 无界链表队列
+        linked_list,
+        // 有界环形队列：不分配内存，满时提交方阻塞（工作线程则先帮忙执行任务）
+        bounded_ring,
+    };
+
+    // 任务优先级（调度通道）
+    enum class priority : u8 {
+        // 高优先级：延迟敏感的任务
+        high = 0,
+        // 普通优先级：insert()/submit() 的默认通道
+        normal = 1,
+        // 后台：批处理、压缩等
+        background = 2,
+    };
+
+    // 优先级通道数量
+    inline constexpr size_t priority_count = 3;
+
+    // 单个通道的统计信息
+    struct lane_stats {
+        // 当前排队的任务数
+        u64 depth = 0;
+        // 累计提交的任务数
+        u64 submitted = 0;
+        // 累计开始执行的任务数
+        u64 executed = 0;
+        // 平均排队时间（抽样）
+        tools::time::us average_wait{ 0 };
+        // 排队时间的 99 分位（抽样）
+        tools::time::us p99_wait{ 0 };
+        // 最长排队时间（抽样）
+        tools::time::us max_wait{ 0 };
+    };
+
+    // 线程池配置
+    struct pool_options {
+        // 线程数量
+        size_t thread_count = std::thread::hardware_concurrency();
+        // 调度模式
+        schedule_mode mode = schedule_mode::shared_queue;
+        // 空闲线程休眠前的自旋次数（0 表示找不到任务立即休眠）
+        u32 spin_budget = 100;
+        // 共享任务队列的存储方式（仅用于普通通道）
+        queue_backend backend = queue_backend::linked_list;
+        // 有界环形队列的容量
+        u64 queue_capacity = 4096;
+        // 各通道（high, normal, background）的调度权重
+        // 所有通道都有任务时按权重比例取任务，低优先级通道不会饿死
+        std::array<u32, priority_count> lane_weights{ 16, 4, 1 };
+        // 通道内按截止时间优先（EDF）排序，未指定截止时间的任务排在最后
+        // 开启后所有任务都经过加锁的堆，且不使用工作窃取的本地队列
+        bool deadline_ordering = false;
+        // 工作线程可运行的 CPU 编号（空表示不绑定）
+        std::vector<u32> cpu_set;
+        // 每个工作线程只绑定一个 CPU（按编号轮流分配），否则可在整个集合上运行
+        bool pin_each_worker = true;
+        // 工作线程按 NUMA 节点轮流分配并绑定到节点内的 CPU，窃取时优先同节点的线程
+        bool numa_aware = false;
+        // 工作线程名称前缀，实际名称为 "前缀:编号"（空表示不命名）
+        std::string thread_name = "tools_pool";
+        // 每多少个任务记录一次排队时间与执行时间（取 2 的幂，1 表示每个任务，0 表示不记录）
+        // 读取时钟的开销与调度本身相当，默认抽样
+        u64 latency_sample_period = 64;
+    };
+
+    namespace detail {
+        // 帮助式等待者（pool::help_until）的休眠点，进程内共享：有任务提交或等待条件变化时唤醒
+        inline event_count helper_parking;
+    }
+
     class pool {
     public:
-        explicit pool(size_t thread_count = std::thread::hardware_concurrency())
-            : stop(false) {
+        explicit pool(
+            size_t thread_count = std::thread::hardware_concurrency(),
+            schedule_mode mode = schedule_mode::shared_queue)
+            : pool(make_options(thread_count, mode)) {
+        }
+
+        explicit pool(const pool_options& options)
+            : stop(false), mode(options.mode), spin_budget(options.spin_budget) {
+            size_t thread_count = options.thread_count == 0 ? 1 : options.thread_count;
+
+            if (options.backend == queue_backend::bounded_ring) {
+                ring_queue = std::make_unique<data::bounded_queue<queued_task>>(options.queue_capacity);
+            }
+            if (options.deadline_ordering) {
+                for (auto& lane : lanes) {
+                    lane.ordered = std::make_unique<data::deadline_queue<queued_task, tools::time::time_point>>();
+                }
+            }
+            build_schedule(options.lane_weights);
+            if (options.latency_sample_period != 0) {
+                u64 period = 1;
+                while (period < options.latency_sample_period) period <<= 1;
+                sample_mask = period - 1;
+                sampling = true;
+            }
+            external_slot = thread_count;
+            counters = std::make_unique<lane_counters[]>(thread_count + 1);
+
+            if (mode == schedule_mode::work_stealing) {
+                for (size_t i = 0; i < thread_count; ++i) {
+                    locals.emplace_back(std::make_unique<data::steal_deque<queued_task*>>());
+                }
+            }
+            assign_workers(options, thread_count);
             for (size_t i = 0; i < thread_count; ++i) {
-                threads.emplace_back(&pool::worker, this);
+                threads.emplace_back(&pool::worker, this, i);
             }
         }
 
         template<typename F, typename... Args>
         bool insert(F&& f, Args&&... args) {
-            using func_type = void();
+            return insert_to(priority::normal, std::forward<F>(f), std::forward<Args>(args)...);
+        }
 
-            // 包装任务并提交到队列
-            auto task = std::make_shared<std::function<func_type>>(
-                [=] { std::invoke(f, args...); }
-            );
+        // 提交到指定优先级通道
+        template<typename F, typename... Args>
+        bool insert_to(priority lane, F&& f, Args&&... args) {
+            return insert_before(no_deadline, lane, std::forward<F>(f), std::forward<Args>(args)...);
+        }
 
-            if (stop.load(std::memory_order_relaxed)) {
-                return false;
+        // 提交带截止时间的任务（仅在 deadline_ordering 开启时影响顺序）
+        template<typename F, typename... Args>
+        bool insert_before(tools::time::time_point deadline, priority lane, F&& f, Args&&... args) {
+            // 右值任务对象直接提交，避免再包装一层；被拒绝时任务保持不变，调用方可以自行处理
+            if constexpr (sizeof...(Args) == 0 && std::is_same_v<F, task_type>) {
+                return post(lane, deadline, std::move(f));
             }
+            else {
+                // 包装任务并提交到队列，小任务不分配内存
+                return post(lane, deadline, task_type(
+                    [f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable {
+                        std::invoke(f, args...);
+                    }));
+            }
+        }
 
-            task_queue.push([task] { (*task)(); });
-            return true;
+        // 提交任务并返回携带结果（或异常）的 future
+        // 可调用对象与结果共用一次分配
+        template<typename F, typename... Args>
+        auto submit(F&& f, Args&&... args)
+            -> future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> {
+            return submit_to(priority::normal, std::forward<F>(f), std::forward<Args>(args)...);
+        }
+
+        // 提交到指定优先级通道并返回 future
+        template<typename F, typename... Args>
+        auto submit_to(priority lane, F&& f, Args&&... args)
+            -> future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> {
+            using result_type = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+
+            auto bound = [f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable -> result_type {
+                return std::invoke(f, args...);
+            };
+            auto* state = new detail::task_state<result_type, decltype(bound)>(std::move(bound));
+            future<result_type> result(state);
+
+            if (stop.load(std::memory_order_relaxed)) {
+                state->fail(std::make_exception_ptr(std::runtime_error("thread pool is stopped")));
+                state->release();
+                return result;
+            }
+            // 检查之后才停止时 post() 拒绝任务，由 task_runner 的析构报告异常并释放任务的引用
+            post(lane, no_deadline, task_type(detail::task_runner<decltype(state)>(state)));
+            return result;
         }
 
         u64 task_count() const {
-            return task_queue.size();
+            u64 size = 0;
+            for (size_t i = 0; i < priority_count; ++i) {
+                size += lane_size(i);
+            }
+            for (auto& local : locals) {
+                size += local->size();
+            }
+            return size;
+        }
+
+        // 通道统计信息
+        lane_stats stats(priority lane) const {
+            const lane_state& state = lanes[static_cast<size_t>(lane)];
+            lane_stats s;
+            size_t index = static_cast<size_t>(lane);
+            for (size_t i = 0; i <= external_slot; ++i) {
+                s.submitted += counters[i].submitted[index].load(std::memory_order_relaxed);
+                s.executed += counters[i].executed[index].load(std::memory_order_relaxed);
+            }
+            s.depth = s.submitted > s.executed ? s.submitted - s.executed : 0;
+            tools::time::latency_snapshot wait = state.wait_latency.snapshot();
+            s.average_wait = wait.mean();
+            s.p99_wait = wait.percentile(99);
+            s.max_wait = wait.max();
+            return s;
+        }
+
+        // 通道的排队时间分布（从提交到开始执行，抽样）
+        tools::time::latency_snapshot wait_latency(priority lane) const noexcept {
+            return lanes[static_cast<size_t>(lane)].wait_latency.snapshot();
+        }
+
+        // 通道的执行时间分布（抽样）
+        tools::time::latency_snapshot run_latency(priority lane) const noexcept {
+            return lanes[static_cast<size_t>(lane)].run_latency.snapshot();
+        }
+
+        // 累计提交、完成的任务数与未完成的任务数（分片计数，读取不阻塞工作线程）
+        inflight_snapshot snapshot() const noexcept {
+            return count.snapshot();
         }
 
         void wait() {
-            // 先等待任务完成
-            while (task_queue.size() != 0 ||
-                count.load(std::memory_order_acquire) > 0) {
-                std::this_thread::yield();
+            // 先阻塞等待任务完成（已被 join() 停止的线程池不再等待）
+            // 登记等待者后，完成任务的线程会推进 progress 并唤醒
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+            while (!stop.load(std::memory_order_acquire)) {
+                u64 generation = progress.load(std::memory_order_acquire);
+                if (count.idle(std::memory_order_seq_cst)) break;
+                progress.wait(generation, std::memory_order_acquire);
             }
+            waiters.fetch_sub(1, std::memory_order_relaxed);
 
             // 再停止线程
             stop.store(true, std::memory_order_release);
+            parking.notify_all();
 
             for (auto& thread : threads) {
                 if (thread.joinable()) thread.join();
@@ -60,8 +287,44 @@ namespace tools::thread {
             return threads.size();
         }
 
+        // 在当前线程执行一个待处理的任务，没有可执行的任务时返回 false
+        // 供等待中的线程帮忙执行任务，避免嵌套等待时所有工作线程都被阻塞
+        bool try_run_one() {
+            return run_one(current_pool == this ? current_index : locals.size());
+        }
+
+        // 帮助式等待：done() 成立前在当前线程执行本线程池的待处理任务
+        // 没有可执行的任务时休眠，有任务提交（任意线程池）或 wake_helpers() 时醒来重新检查
+        template<typename P>
+        void help_until(P&& done) {
+            while (!done()) {
+                if (try_run_one()) continue;
+                // 登记后再次检查，提交与条件变化都不会丢失唤醒
+                event_count::key key = detail::helper_parking.prepare_wait();
+                if (done() || has_work()) {
+                    detail::helper_parking.cancel_wait();
+                }
+                else {
+                    detail::helper_parking.commit_wait(key);
+                }
+            }
+        }
+
+        // 唤醒 help_until() 中休眠的线程，在等待条件变为成立后调用
+        static void wake_helpers() noexcept {
+            detail::helper_parking.notify_all();
+        }
+
+        schedule_mode get_mode() const {
+            return mode;
+        }
+
         void join() {
             stop.store(true, std::memory_order_release);
+            parking.notify_all();
+            // 唤醒阻塞在 wait() 中的线程
+            progress.fetch_add(1, std::memory_order_release);
+            progress.notify_all();
 
             for (auto& thread : threads) {
                 if (thread.joinable()) {
@@ -72,49 +335,410 @@ namespace tools::thread {
 
         ~pool() {
             wait();
+
+            // 释放 join() 后本地队列中未执行的任务
+            for (auto& local : locals) {
+                while (auto task = local->pop()) {
+                    task_owner owner(*task);
+                }
+            }
         }
 
     private:
-        void worker() {
-            constexpr int max_spin = 100;     // 最大自旋次数
-            constexpr int base_delay = 100;   // 基础延迟(微秒)
-            int current_spin = max_spin;      // 当前剩余自旋次数
-            int current_delay = base_delay;   // 当前延迟时间
+        // 只指定线程数与调度模式的配置，其余字段取默认值
+        static pool_options make_options(size_t thread_count, schedule_mode mode) {
+            pool_options options;
+            options.thread_count = thread_count;
+            options.mode = mode;
+            return options;
+        }
+
+        using task_type = tools::thread::task;
+
+        // 队列中的任务及入队时间（未抽样的任务为默认值）
+        struct queued_task {
+            task_type task;
+            tools::time::time_point enqueued;
+        };
+
+        // 本地队列只存指针，任务从节点池分配，提交不经过系统分配器
+        struct task_release {
+            void operator()(queued_task* task) const noexcept {
+                node_pool<queued_task>::instance().destroy(task);
+            }
+        };
+        using task_owner = std::unique_ptr<queued_task, task_release>;
+
+        // 通道：无序时为先进先出队列，开启截止时间排序时为堆
+        struct lane_state {
+            data::queue<queued_task> fifo;
+            std::unique_ptr<data::deadline_queue<queued_task, tools::time::time_point>> ordered;
+            // 抽样的排队时间与执行时间
+            tools::time::latency_histogram wait_latency;
+            tools::time::latency_histogram run_latency;
+        };
+
+        static constexpr tools::time::time_point no_deadline = tools::time::time_point::max();
+
+        // 按权重生成平滑加权轮询序列，例如权重 {2, 1, 1} 生成 0 1 0 2
+        void build_schedule(const std::array<u32, priority_count>& weights) {
+            i64 total = 0;
+            std::array<i64, priority_count> current{};
+            for (u32 w : weights) total += w;
+            if (total == 0) {
+                schedule = { 0, 1, 2 };
+                return;
+            }
+            for (i64 step = 0; step < total; ++step) {
+                size_t best = 0;
+                for (size_t i = 0; i < priority_count; ++i) {
+                    current[i] += weights[i];
+                    if (current[i] > current[best]) best = i;
+                }
+                current[best] -= total;
+                schedule.push_back(static_cast<u8>(best));
+            }
+        }
+
+        u64 lane_size(size_t lane) const {
+            const lane_state& state = lanes[lane];
+            if (state.ordered) return state.ordered->size();
+            if (lane == static_cast<size_t>(priority::normal) && ring_queue) return ring_queue->size();
+            return state.fifo.size();
+        }
+
+        // 通道是否为空，不汇总分片计数
+        bool lane_empty(size_t lane) const {
+            const lane_state& state = lanes[lane];
+            if (state.ordered) return state.ordered->empty();
+            if (lane == static_cast<size_t>(priority::normal) && ring_queue) return ring_queue->empty();
+            return state.fifo.empty();
+        }
+
+        // 将任务放入队列
+        bool post(priority lane, tools::time::time_point deadline, task_type&& task) {
+            if (stop.load(std::memory_order_relaxed)) {
+                return false;
+            }
+
+            count.begin();
+            size_t index = static_cast<size_t>(lane);
+            lane_state& state = lanes[index];
+            u64 sequence = bump(local_counters().submitted[index]);
+            queued_task entry{ std::move(task), sampling && (sequence & sample_mask) == 0
+                ? tools::time::time_now() : tools::time::default_time_point };
+
+            if (state.ordered) {
+                state.ordered->push(deadline, std::move(entry));
+            }
+            // 工作窃取模式下，工作线程提交的普通任务放入自身的本地队列
+            else if (lane == priority::normal && current_pool == this && mode == schedule_mode::work_stealing) {
+                task_owner owner(node_pool<queued_task>::instance().create(std::move(entry)));
+                locals[current_index]->push(owner.get());
+                owner.release();
+            }
+            else if (lane == priority::normal) {
+                push_shared(std::move(entry));
+            }
+            else {
+                state.fifo.push(std::move(entry));
+            }
+            TOOLS_TRACE_INSTANT("pool", "enqueue", index);
+
+            // 唤醒一个休眠的线程，以及帮助式等待中的线程（复用 notify_one 中的屏障）
+            parking.notify_one();
+            detail::helper_parking.notify_all_after_fence();
+            return true;
+        }
+
+        // 放入普通通道的共享队列
+        // 有界队列已满时，本线程池的工作线程帮忙执行任务以免全部阻塞，外部线程阻塞等待空位
+        void push_shared(queued_task&& task) {
+            if (!ring_queue) {
+                lanes[static_cast<size_t>(priority::normal)].fifo.push(std::move(task));
+                return;
+            }
+            if (current_pool != this) {
+                ring_queue->push(std::move(task));
+                return;
+            }
+            while (!ring_queue->try_push(std::move(task))) {
+                run_one(current_index);
+            }
+        }
+
+        // 从通道的共享队列取出
+        std::optional<queued_task> pop_lane(size_t lane) {
+            lane_state& state = lanes[lane];
+            if (state.ordered) return state.ordered->pop();
+            if (lane == static_cast<size_t>(priority::normal) && ring_queue) return ring_queue->try_pop();
+            return state.fifo.pop();
+        }
+
+        // 运行一个任务并更新计数，最后一个任务完成时唤醒 wait()
+        void run(size_t lane, queued_task& entry) {
+            lane_state& state = lanes[lane];
+            bump(local_counters().executed[lane]);
+
+            TOOLS_TRACE_INSTANT("pool", "dequeue", lane);
+            if (entry.enqueued != tools::time::default_time_point) {
+                tools::time::time_point started = tools::time::time_now();
+                state.wait_latency.record(started - entry.enqueued);
+                TOOLS_TRACE_SCOPE_ARG("pool", "run", lane);
+                entry.task();
+                state.run_latency.record_since(started);
+            }
+            else {
+                TOOLS_TRACE_SCOPE_ARG("pool", "run", lane);
+                entry.task();
+            }
+            // 与 wait() 中登记等待者、读取计数的顺序配对，不会漏掉唤醒
+            // 有等待者时才汇总计数，只有完成最后一个任务的线程唤醒等待者
+            count.end(1, std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_seq_cst) != 0 && count.idle(std::memory_order_seq_cst)) {
+                progress.fetch_add(1, std::memory_order_release);
+                progress.notify_all();
+            }
+        }
+
+        // 每个工作线程独占一组计数，外部线程共用最后一组，读取统计时求和
+        struct alignas(64) lane_counters {
+            std::array<std::atomic<u64>, priority_count> submitted{};
+            std::array<std::atomic<u64>, priority_count> executed{};
+        };
+
+        lane_counters& local_counters() noexcept {
+            return counters[current_pool == this ? current_index : external_slot];
+        }
+
+        // 计数加一并返回旧值：工作线程独占的计数无需原子读改写
+        u64 bump(std::atomic<u64>& counter) noexcept {
+            if (current_pool == this) {
+                u64 old = counter.load(std::memory_order_relaxed);
+                counter.store(old + 1, std::memory_order_relaxed);
+                return old;
+            }
+            return counter.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // 从指定通道获取并运行一个任务，普通通道优先取本地队列
+        bool run_lane(size_t lane, size_t index) {
+            if (lane == static_cast<size_t>(priority::normal) && index < locals.size()) {
+                if (auto task = locals[index]->pop()) {
+                    task_owner owner(*task);
+                    run(lane, *owner);
+                    return true;
+                }
+            }
+            // 空通道不进入队列
+            if (lane_empty(lane)) return false;
+            if (auto task = pop_lane(lane)) {
+                run(lane, *task);
+                return true;
+            }
+            return false;
+        }
+
+        // 尝试获取并运行一个任务（index 为工作线程编号，外部线程传入 locals.size()）
+        // 按加权轮询选出首选通道，首选通道为空时按优先级依次尝试其他通道，最后窃取
+        bool run_one(size_t index) {
+            size_t preferred = schedule[lane_cursor++ % schedule.size()];
+            if (run_lane(preferred, index)) return true;
+            for (size_t lane = 0; lane < priority_count; ++lane) {
+                if (lane != preferred && run_lane(lane, index)) return true;
+            }
+            return steal_one(index);
+        }
+
+        // 是否有可获取的任务
+        bool has_work() const {
+            for (size_t i = 0; i < priority_count; ++i) {
+                if (!lane_empty(i)) return true;
+            }
+            for (auto& local : locals) {
+                if (!local->empty()) return true;
+            }
+            return false;
+        }
+
+        // 从随机位置开始遍历其他线程的本地队列窃取一个任务（self 为自身编号，外部线程传入 locals.size()）
+        // 按 NUMA 分配时先遍历同节点的线程，再遍历其他节点
+        bool steal_one(size_t self) {
+            size_t n = locals.size();
+            if (n == 0) return false;
+            size_t start = static_cast<size_t>(next_random() % n);
+            int passes = numa_aware && self < n ? 2 : 1;
+            for (int pass = 0; pass < passes; ++pass) {
+                for (size_t i = 0; i < n; ++i) {
+                    size_t victim = (start + i) % n;
+                    if (victim == self) continue;
+                    if (passes == 2 && (worker_node[victim] == worker_node[self]) != (pass == 0)) continue;
+                    if (auto task = locals[victim]->steal()) {
+                        task_owner owner(*task);
+                        run(static_cast<size_t>(priority::normal), *owner);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // 计算每个工作线程绑定的 CPU 与所属 NUMA 节点
+        void assign_workers(const pool_options& options, size_t thread_count) {
+            worker_cpus.assign(thread_count, {});
+            worker_node.assign(thread_count, 0);
+            numa_aware = options.numa_aware;
+            thread_name = options.thread_name;
+
+            if (options.numa_aware) {
+                std::vector<numa_node> nodes;
+                for (auto& node : numa_topology()) {
+                    // 只保留 cpu_set 中的 CPU
+                    if (!options.cpu_set.empty()) {
+                        std::vector<u32> cpus;
+                        for (u32 cpu : node.cpus) {
+                            if (std::find(options.cpu_set.begin(), options.cpu_set.end(), cpu) != options.cpu_set.end()) {
+                                cpus.push_back(cpu);
+                            }
+                        }
+                        node.cpus = std::move(cpus);
+                    }
+                    if (!node.cpus.empty()) nodes.push_back(std::move(node));
+                }
+                if (nodes.empty()) return;
+
+                for (size_t i = 0; i < thread_count; ++i) {
+                    const numa_node& node = nodes[i % nodes.size()];
+                    worker_node[i] = node.id;
+                    if (options.pin_each_worker) {
+                        worker_cpus[i] = { node.cpus[(i / nodes.size()) % node.cpus.size()] };
+                    }
+                    else {
+                        worker_cpus[i] = node.cpus;
+                    }
+                }
+            }
+            else if (!options.cpu_set.empty()) {
+                for (size_t i = 0; i < thread_count; ++i) {
+                    if (options.pin_each_worker) {
+                        worker_cpus[i] = { options.cpu_set[i % options.cpu_set.size()] };
+                    }
+                    else {
+                        worker_cpus[i] = options.cpu_set;
+                    }
+                }
+            }
+        }
+
+        // 线程局部的 xorshift 随机数，用于选择窃取对象
+        static u64 next_random() {
+            static thread_local u64 state =
+                std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+
+        void worker(size_t index) {
+            u32 current_spin = spin_budget;   // 当前剩余自旋次数
+
+            current_pool = this;
+            current_index = index;
+
+            if (!worker_cpus[index].empty()) {
+                pin_current_thread(worker_cpus[index]);
+            }
+            if (!thread_name.empty()) {
+                set_current_thread_name(thread_name + ":" + std::to_string(index));
+            }
 
             while (!stop.load(std::memory_order_acquire)) {
                 // 尝试获取任务
-                if (auto task = task_queue.pop()) {
-                    ++count;
-                    (*task)();
-                    --count;
-
-                    // 成功获取任务后重置状态
-                    current_spin = max_spin;
-                    current_delay = base_delay;
+                if (run_one(index)) {
+                    // 成功获取任务后重置自旋次数
+                    current_spin = spin_budget;
                     continue;
                 }
 
                 // 自旋阶段控制
-                if (--current_spin > 0) {
-                    //std::this_thread::yield(); // 轻度退让
+                if (current_spin > 0) {
+                    --current_spin;
                     continue;
                 }
 
-                // 进入退避阶段
-                std::this_thread::sleep_for(
-                    std::chrono::microseconds(current_delay));
-
-                // 指数退避策略（上限1ms）
-                current_delay = std::min(current_delay * 2, 1000);
+                // 休眠阶段：登记后再次检查，避免丢失唤醒
+                event_count::key key = parking.prepare_wait();
+                if (stop.load(std::memory_order_acquire) || has_work()) {
+                    parking.cancel_wait();
+                }
+                else {
+                    parking.commit_wait(key);
+                }
+                current_spin = spin_budget;
             }
+
+            current_pool = nullptr;
         }
-        // 任务队列
-        tools::thread::data::queue<std::function<void()>> task_queue;
+        // 优先级通道（普通通道的链表队列即原共享任务队列）
+        std::array<lane_state, priority_count> lanes;
+        // 各线程的通道计数（thread_count + 1 组，最后一组属于外部线程）
+        std::unique_ptr<lane_counters[]> counters;
+        size_t external_slot = 0;
+        // 加权轮询序列，元素为通道编号
+        std::vector<u8> schedule;
+        // 有界环形任务队列（backend 为 bounded_ring 时作为普通通道使用）
+        std::unique_ptr<data::bounded_queue<queued_task>> ring_queue;
+        // 工作窃取模式下每个线程的本地队列
+        std::vector<std::unique_ptr<data::steal_deque<queued_task*>>> locals;
+        // 每个工作线程绑定的 CPU（空表示不绑定）
+        std::vector<std::vector<u32>> worker_cpus;
+        // 每个工作线程所属的 NUMA 节点
+        std::vector<u32> worker_node;
+        // 是否按 NUMA 节点窃取
+        bool numa_aware = false;
+        // 工作线程名称前缀
+        std::string thread_name;
         // 线程池
         std::vector<std::thread> threads;
         // 停止标志
         std::atomic<bool> stop;
-        // 任务计数器
-        std::atomic<u64> count{ 0 };
+        // 调度模式
+        schedule_mode mode;
+        // 休眠前自旋次数
+        u32 spin_budget;
+        // 延迟抽样：提交序号与 sample_mask 相与为 0 的任务记录排队与执行时间
+        bool sampling = false;
+        u64 sample_mask = 0;
+        // 空闲线程休眠点
+        event_count parking;
+        // 未完成的任务计数（已提交但尚未执行完毕），按线程分片
+        inflight_counter count;
+        // 阻塞在 wait() 中的线程数，以及唤醒它们的进度序号
+        std::atomic<u32> waiters{ 0 };
+        std::atomic<u64> progress{ 0 };
+
+        // 当前线程所属的线程池及其编号
+        static inline thread_local pool* current_pool = nullptr;
+        static inline thread_local size_t current_index = 0;
+        // 当前线程在加权轮询序列中的位置
+        static inline thread_local u64 lane_cursor = 0;
     };
-};
\ No newline at end of file
+
+    // 每个 NUMA 节点创建一个线程池，线程绑定到该节点的 CPU，线程数等于节点的 CPU 数
+    // 数据由所属节点的线程池初始化并处理，可保证内存访问留在本地节点
+    inline std::vector<std::unique_ptr<pool>> make_numa_pools(const pool_options& base = pool_options()) {
+        std::vector<std::unique_ptr<pool>> pools;
+        for (auto& node : numa_topology()) {
+            pool_options options = base;
+            options.thread_count = node.cpus.size();
+            options.cpu_set = node.cpus;
+            options.numa_aware = false;
+            if (!base.thread_name.empty()) {
+                options.thread_name = base.thread_name + "." + std::to_string(node.id);
+            }
+            pools.push_back(std::make_unique<pool>(options));
+        }
+        return pools;
+    }
+};
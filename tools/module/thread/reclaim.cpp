@@ -0,0 +1,240 @@
+#include "reclaim.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace tools::thread::reclaim {
+    namespace {
+        // 每累计多少个待释放对象尝试推进一次纪元
+        constexpr u64 collect_threshold = 64;
+        // 纪元值最低位表示线程是否处于临界区
+        constexpr u64 active_bit = 1;
+
+        struct retired_object {
+            void* pointer;
+            void (*deleter)(void*);
+        };
+
+        // 同一纪元内摘除的对象
+        struct bag {
+            u64 epoch = 0;
+            std::vector<retired_object> objects;
+
+            void free_all() noexcept {
+                for (auto& object : objects) {
+                    object.deleter(object.pointer);
+                }
+                objects.clear();
+            }
+        };
+
+        // 线程记录，挂在全局无锁链表上，线程退出后可被新线程复用
+        struct thread_record {
+            // (纪元 << 1) | 是否处于临界区
+            alignas(64) std::atomic<u64> state{ 0 };
+            std::atomic<bool> in_use{ true };
+            thread_record* next = nullptr;
+
+            // 以下仅由拥有者线程访问
+            u32 nesting = 0;
+            u64 pending = 0;
+            bag bags[3];
+        };
+
+        class domain {
+        public:
+            static domain& instance() {
+                static domain d;
+                return d;
+            }
+
+            ~domain() {
+                // 进程退出时释放所有剩余对象
+                thread_record* record = records.load(std::memory_order_acquire);
+                while (record) {
+                    thread_record* next = record->next;
+                    for (auto& b : record->bags) b.free_all();
+                    delete record;
+                    record = next;
+                }
+                for (auto& b : orphans) b.free_all();
+            }
+
+            // 获取（或复用）一个线程记录
+            thread_record* acquire() {
+                for (thread_record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+                    bool expected = false;
+                    if (!r->in_use.load(std::memory_order_relaxed) &&
+                        r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                        return r;
+                    }
+                }
+                auto* r = new thread_record();
+                thread_record* head = records.load(std::memory_order_relaxed);
+                do {
+                    r->next = head;
+                } while (!records.compare_exchange_weak(
+                    head, r,
+                    std::memory_order_release,
+                    std::memory_order_relaxed));
+                return r;
+            }
+
+            // 线程退出：未释放的对象交给孤儿列表，记录留给其他线程复用
+            void release(thread_record* r) {
+                {
+                    std::lock_guard<std::mutex> lock(orphans_mutex);
+                    for (auto& b : r->bags) {
+                        if (!b.objects.empty()) {
+                            orphans.push_back(std::move(b));
+                            b = bag();
+                        }
+                    }
+                }
+                r->pending = 0;
+                r->in_use.store(false, std::memory_order_release);
+            }
+
+            void enter(thread_record* r) noexcept {
+                if (r->nesting++ == 0) {
+                    u64 e = global_epoch.load(std::memory_order_acquire);
+                    // release：上一次临界区内的访问先行于推进纪元的线程
+                    r->state.store((e << 1) | active_bit, std::memory_order_release);
+                    // 保证读取共享指针之前，其他线程能看到本线程已进入临界区
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                }
+            }
+
+            void leave(thread_record* r) noexcept {
+                if (--r->nesting == 0) {
+                    r->state.store(r->state.load(std::memory_order_relaxed) & ~active_bit,
+                        std::memory_order_release);
+                }
+            }
+
+            void retire(thread_record* r, void* p, void (*deleter)(void*)) {
+                // 以对象摘除之后读到的全局纪元作为标记，且不小于 l + 1（l 为本线程所在纪元）
+                // 进入临界区时读到的纪元可能已经落后，不能只依赖 l + 1
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                u64 e = global_epoch.load(std::memory_order_acquire);
+                if (r->nesting > 0) {
+                    e = std::max(e, (r->state.load(std::memory_order_relaxed) >> 1) + 1);
+                }
+
+                bag& b = r->bags[e % 3];
+                if (b.epoch != e) {
+                    // 同一槽位上一次使用的标记至少早 3 个，已安全
+                    freed.fetch_add(b.objects.size(), std::memory_order_relaxed);
+                    r->pending -= b.objects.size();
+                    b.free_all();
+                    b.epoch = e;
+                }
+                b.objects.push_back({ p, deleter });
+                retired.fetch_add(1, std::memory_order_relaxed);
+
+                if (++r->pending >= collect_threshold) {
+                    collect(r);
+                }
+            }
+
+            // 推进纪元，并释放本线程与孤儿列表中已安全的对象
+            void collect(thread_record* r) {
+                try_advance();
+                u64 e = global_epoch.load(std::memory_order_acquire);
+                for (auto& b : r->bags) {
+                    if (!b.objects.empty() && b.epoch + 2 <= e) {
+                        freed.fetch_add(b.objects.size(), std::memory_order_relaxed);
+                        r->pending -= b.objects.size();
+                        b.free_all();
+                    }
+                }
+
+                std::unique_lock<std::mutex> lock(orphans_mutex, std::try_to_lock);
+                if (lock.owns_lock()) {
+                    for (size_t i = 0; i < orphans.size();) {
+                        if (orphans[i].epoch + 2 <= e) {
+                            freed.fetch_add(orphans[i].objects.size(), std::memory_order_relaxed);
+                            orphans[i].free_all();
+                            orphans[i] = std::move(orphans.back());
+                            orphans.pop_back();
+                        }
+                        else {
+                            ++i;
+                        }
+                    }
+                }
+            }
+
+            // 所有处于临界区的线程都已观察到当前纪元时才推进
+            bool try_advance() noexcept {
+                u64 e = global_epoch.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                for (thread_record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+                    u64 s = r->state.load(std::memory_order_acquire);
+                    if ((s & active_bit) && (s >> 1) != e) {
+                        return false;
+                    }
+                }
+                return global_epoch.compare_exchange_strong(
+                    e, e + 1,
+                    std::memory_order_acq_rel,
+                    std::memory_order_relaxed);
+            }
+
+            statistics snapshot() const noexcept {
+                statistics s;
+                s.retired = retired.load(std::memory_order_relaxed);
+                s.freed = freed.load(std::memory_order_relaxed);
+                s.epoch = global_epoch.load(std::memory_order_relaxed);
+                return s;
+            }
+
+        private:
+            domain() = default;
+
+            alignas(64) std::atomic<u64> global_epoch{ 0 };
+            alignas(64) std::atomic<thread_record*> records{ nullptr };
+            std::mutex orphans_mutex;
+            std::vector<bag> orphans;
+            alignas(64) std::atomic<u64> retired{ 0 };
+            std::atomic<u64> freed{ 0 };
+        };
+
+        // 线程退出时归还记录
+        struct local_record {
+            thread_record* record;
+
+            local_record() : record(domain::instance().acquire()) {}
+            ~local_record() {
+                domain::instance().release(record);
+            }
+        };
+
+        thread_record* current() {
+            static thread_local local_record local;
+            return local.record;
+        }
+    }
+
+    epoch_guard::epoch_guard() noexcept {
+        domain::instance().enter(current());
+    }
+
+    epoch_guard::~epoch_guard() noexcept {
+        domain::instance().leave(current());
+    }
+
+    void retire(void* p, void (*deleter)(void*)) {
+        domain::instance().retire(current(), p, deleter);
+    }
+
+    void collect() {
+        domain::instance().collect(current());
+    }
+
+    statistics stats() noexcept {
+        return domain::instance().snapshot();
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../../base.hpp"
+
+namespace tools::thread::reclaim {
+    // 基于纪元（epoch）的安全内存回收
+    // 无锁容器在访问共享节点前创建 epoch_guard；摘除的节点通过 retire() 延迟释放，
+    // 直到所有在摘除时可能持有该节点的线程都已离开临界区
+    //
+    // 用法：
+    //     reclaim::epoch_guard guard;
+    //     node* n = head.load();  // n 在 guard 存活期间不会被释放
+    //     ...
+    //     reclaim::retire(old_node);
+
+    // 临界区守卫，可嵌套
+    class epoch_guard {
+    public:
+        epoch_guard() noexcept;
+        ~epoch_guard() noexcept;
+
+        epoch_guard(const epoch_guard&) = delete;
+        epoch_guard& operator=(const epoch_guard&) = delete;
+    };
+
+    // 延迟释放 p，安全时调用 deleter(p)
+    // 应在摘除 p 时所处的 epoch_guard 内调用
+    void retire(void* p, void (*deleter)(void*));
+
+    // 延迟 delete p
+    template<typename T>
+    void retire(T* p) {
+        retire(static_cast<void*>(p), [](void* q) { delete static_cast<T*>(q); });
+    }
+
+    // 尝试推进纪元并释放已安全的对象
+    void collect();
+
+    // 统计信息
+    struct statistics {
+        // 累计延迟释放的对象数
+        u64 retired = 0;
+        // 累计已释放的对象数
+        u64 freed = 0;
+        // 当前全局纪元
+        u64 epoch = 0;
+    };
+    statistics stats() noexcept;
+}
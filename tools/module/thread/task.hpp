@@ -0,0 +1,117 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tools::thread {
+    // 只可移动的任务类型，带内联存储
+    // 不超过 inline_size 且可无异常移动的可调用对象直接存放在对象内部，不分配内存；
+    // 更大的对象退化为一次堆分配
+    class task {
+    public:
+        // 内联存储大小，整个对象恰好占一个缓存行
+        static constexpr size_t inline_size = 48;
+
+        task() noexcept = default;
+
+        template<typename F,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::decay_t<F>, task> && std::is_invocable_v<std::decay_t<F>&>>>
+        task(F&& f) {
+            using func_type = std::decay_t<F>;
+            if constexpr (fits_inline<func_type>) {
+                ::new (static_cast<void*>(storage)) func_type(std::forward<F>(f));
+                table = &inline_table<func_type>;
+            }
+            else {
+                ::new (static_cast<void*>(storage)) func_type*(new func_type(std::forward<F>(f)));
+                table = &heap_table<func_type>;
+            }
+        }
+
+        task(task&& other) noexcept {
+            move_from(other);
+        }
+
+        task& operator=(task&& other) noexcept {
+            if (this != &other) {
+                reset();
+                move_from(other);
+            }
+            return *this;
+        }
+
+        task(const task&) = delete;
+        task& operator=(const task&) = delete;
+
+        ~task() {
+            reset();
+        }
+
+        // 执行任务
+        void operator()() {
+            table->invoke(storage);
+        }
+
+        // 是否持有可调用对象
+        explicit operator bool() const noexcept {
+            return table != nullptr;
+        }
+
+        // 该类型的可调用对象是否内联存储（不分配内存）
+        template<typename F>
+        static constexpr bool fits_inline =
+            sizeof(F) <= inline_size &&
+            alignof(F) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible_v<F>;
+
+        // 释放持有的可调用对象
+        void reset() noexcept {
+            if (table) {
+                table->destroy(storage);
+                table = nullptr;
+            }
+        }
+
+    private:
+        // 类型擦除操作表
+        struct vtable {
+            void (*invoke)(void* storage);
+            void (*move)(void* dst, void* src) noexcept;
+            void (*destroy)(void* storage) noexcept;
+        };
+
+        template<typename F>
+        static constexpr vtable inline_table = {
+            [](void* storage) { (*static_cast<F*>(storage))(); },
+            [](void* dst, void* src) noexcept {
+                ::new (dst) F(std::move(*static_cast<F*>(src)));
+                static_cast<F*>(src)->~F();
+            },
+            [](void* storage) noexcept { static_cast<F*>(storage)->~F(); },
+        };
+
+        template<typename F>
+        static constexpr vtable heap_table = {
+            [](void* storage) { (**static_cast<F**>(storage))(); },
+            [](void* dst, void* src) noexcept {
+                ::new (dst) F*(*static_cast<F**>(src));
+            },
+            [](void* storage) noexcept { delete* static_cast<F**>(storage); },
+        };
+
+        void move_from(task& other) noexcept {
+            if (other.table) {
+                other.table->move(storage, other.storage);
+                table = std::exchange(other.table, nullptr);
+            }
+        }
+
+        alignas(std::max_align_t) std::byte storage[inline_size];
+        const vtable* table = nullptr;
+    };
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "../../base.hpp"
+
+// 线程池
+#include "pool.hpp"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace tools::thread {
+    namespace detail {
+        // 等待 counter 归零：有 helper 时期间执行其中的待处理任务，没有任务可执行时休眠，
+        // 新任务提交或计数归零（归零方调用 pool::wake_helpers()）时醒来；没有 helper 时只等归零
+        inline void help_until_zero(const std::atomic<u64>& counter, pool* helper) {
+            if (helper) {
+                helper->help_until([&counter] { return counter.load(std::memory_order_acquire) == 0; });
+                return;
+            }
+            u64 current = counter.load(std::memory_order_acquire);
+            while (current != 0) {
+                counter.wait(current, std::memory_order_acquire);
+                current = counter.load(std::memory_order_acquire);
+            }
+        }
+    }
+
+    // 一次性倒计数门闩
+    // 与 std::latch 相同，门闩须在最后一次 count_down 返回前保持存活
+    class latch {
+    public:
+        explicit latch(u64 count) noexcept : counter(count) {}
+
+        latch(const latch&) = delete;
+        latch& operator=(const latch&) = delete;
+
+        void count_down(u64 n = 1) noexcept {
+            if (counter.fetch_sub(n, std::memory_order_acq_rel) == n) {
+                counter.notify_all();
+                pool::wake_helpers();
+            }
+        }
+
+        bool try_wait() const noexcept {
+            return counter.load(std::memory_order_acquire) == 0;
+        }
+
+        // 阻塞等待计数归零
+        void wait() const {
+            detail::help_until_zero(counter, nullptr);
+        }
+
+        // 等待期间在当前线程执行 helper 中的任务
+        void wait(pool& helper) const {
+            detail::help_until_zero(counter, &helper);
+        }
+
+    private:
+        std::atomic<u64> counter;
+    };
+
+    // 任务组：只等待组内提交的任务，线程池继续运行
+    // 等待的线程会执行线程池中的待处理任务，工作线程内嵌套等待不会死锁
+    // 组内任务抛出的第一个异常在 wait() 中重新抛出
+    class task_group {
+    private:
+        // 组状态由任务共同持有，最后一个任务完成后等待者可以立即销毁任务组
+        struct state {
+            std::atomic<u64> pending{ 0 };
+            std::mutex error_mutex;
+            std::exception_ptr error;
+
+            void fail(std::exception_ptr e) noexcept {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::move(e);
+            }
+
+            void arrive() noexcept {
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    pending.notify_all();
+                    pool::wake_helpers();
+                }
+            }
+        };
+
+        // 组内任务：执行后到达；未执行就被丢弃（线程池已停止）时以异常到达
+        template<typename F>
+        class runner {
+        public:
+            runner(std::shared_ptr<state> group, F&& func)
+                : group(std::move(group)), func(std::move(func)) {}
+
+            runner(runner&& other) noexcept
+                : group(std::move(other.group)), func(std::move(other.func)) {}
+            runner& operator=(runner&&) = delete;
+
+            ~runner() {
+                if (group) {
+                    group->fail(std::make_exception_ptr(std::runtime_error("task was discarded")));
+                    group->arrive();
+                }
+            }
+
+            void operator()() noexcept {
+                std::shared_ptr<state> owner = std::move(group);
+                try {
+                    func();
+                }
+                catch (...) {
+                    owner->fail(std::current_exception());
+                }
+                owner->arrive();
+            }
+
+        private:
+            std::shared_ptr<state> group;
+            F func;
+        };
+
+    public:
+        explicit task_group(pool& workers)
+            : workers(workers), shared(std::make_shared<state>()) {}
+
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        // 析构时等待组内任务完成（不抛出异常）
+        ~task_group() {
+            detail::help_until_zero(shared->pending, &workers);
+        }
+
+        // 提交组内任务，可在组内任务中继续提交
+        template<typename F, typename... Args>
+        void run(F&& f, Args&&... args) {
+            auto bound = [f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable {
+                std::invoke(f, args...);
+            };
+            shared->pending.fetch_add(1, std::memory_order_relaxed);
+            workers.insert(runner<decltype(bound)>(shared, std::move(bound)));
+        }
+
+        // 等待组内已提交的任务全部完成，等待期间帮忙执行线程池中的任务
+        // 之后任务组可以继续使用
+        void wait() {
+            detail::help_until_zero(shared->pending, &workers);
+
+            std::exception_ptr error;
+            {
+                std::lock_guard<std::mutex> lock(shared->error_mutex);
+                error = std::exchange(shared->error, nullptr);
+            }
+            if (error) std::rethrow_exception(error);
+        }
+
+        // 组内任务是否全部完成
+        bool done() const noexcept {
+            return shared->pending.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        pool& workers;
+        std::shared_ptr<state> shared;
+    };
+}
@@ -2,20 +2,40 @@
 
 #include "../../base.hpp"
 
+// 阻塞等待
+#include "event_count.hpp"
 
+// 内存回收
+#include "reclaim.hpp"
 
+// 节点池
+#include "node_pool.hpp"
+
+// 分片计数器
+#include "counter.hpp"
+
+
+
+#include <algorithm>
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <thread>
 #include <stdexcept>
 #include <chrono>
 #include <utility>
+#include <vector>
+#include <type_traits>
+#include <cstddef>
+#include <functional>
+#include <new>
 
 namespace tools::thread::data {
 
     // 线程安全队列
     // 同时进和出
+    // 节点取自 node_pool，稳定状态下 push/pop 不向系统申请内存
     template<typename T>
     class queue {
     private:
@@ -27,34 +47,43 @@ namespace tools::thread::data {
             node() : next(nullptr) {}  // 哨兵节点构造函数
         };
 
+        using pool_type = node_pool<node>;
+
         std::atomic<node*> head;
         std::atomic<node*> tail;
-        std::atomic<u64> count{ 0 };  // 原子计数器
+        // 入队与出队次数，分片累加避免所有线程争抢同一缓存行
+        inflight_counter count;
 
     public:
-        queue() {
+        // reserve：预分配的节点数，放入全局节点池
+        explicit queue(u64 reserve = 0) {
+            if (reserve > 0) pool_type::instance().reserve(reserve);
             // 初始化哨兵节点
-            node* dummy = new node();
+            node* dummy = pool_type::instance().create();
             head.store(dummy);
             tail.store(dummy);
         }
 
         ~queue() {
-            // 清空延迟删除的节点
-            static thread_local std::vector<node*> garbage;
-            for (auto p : garbage) delete p;
-            garbage.clear();
-            // 清空队列
-            while (pop().has_value());
-            delete head.load();  // 删除最后的哨兵节点
+            // 析构时独占访问，直接释放全部节点
+            node* n = head.load(std::memory_order_relaxed);
+            while (n) {
+                node* next = n->next.load(std::memory_order_relaxed);
+                pool_type::instance().destroy(n);
+                n = next;
+            }
         }
 
         void push(T value) {
-            node* new_node = new node(std::move(value));
-            node* old_tail = tail.load(std::memory_order_relaxed);
+            node* new_node = pool_type::instance().create(std::move(value));
+            // 先计入，出队计数不会超过入队计数
+            count.begin();
+            // 临界区内访问的节点不会被其他线程释放
+            reclaim::epoch_guard guard;
+            node* old_tail = tail.load(std::memory_order_acquire);
 
             while (true) {
-                node* next = old_tail->next.load(std::memory_order_relaxed);
+                node* next = old_tail->next.load(std::memory_order_acquire);
 
                 if (!next) {
                     if (old_tail->next.compare_exchange_weak(
@@ -62,7 +91,6 @@ namespace tools::thread::data {
                         std::memory_order_acq_rel,
                         std::memory_order_acquire))
                     {
-                        count.fetch_add(1, std::memory_order_relaxed);
                         break;
                     }
                 }
@@ -70,49 +98,544 @@ namespace tools::thread::data {
                     // 帮助推进尾指针
                     tail.compare_exchange_weak(
                         old_tail, next,
-                        std::memory_order_relaxed,
+                        std::memory_order_release,
                         std::memory_order_relaxed);
                 }
-                old_tail = tail.load(std::memory_order_relaxed);
+                old_tail = tail.load(std::memory_order_acquire);
             }
 
             // 更新尾指针
-            tail.compare_exchange_weak(
+            tail.compare_exchange_strong(
                 old_tail, new_node,
                 std::memory_order_release,
                 std::memory_order_relaxed);
         }
 
         std::optional<T> pop() {
+            reclaim::epoch_guard guard;
             node* old_head;
             node* next;
-            node* expected_next;
 
-            do {
+            while (true) {
                 old_head = head.load(std::memory_order_acquire);
+                node* old_tail = tail.load(std::memory_order_acquire);
                 next = old_head->next.load(std::memory_order_acquire);
 
                 if (!next) return std::nullopt;
 
-                // 预加载数据防止移动后访问
-                expected_next = next;
-            } while (!head.compare_exchange_weak(
-                old_head, expected_next,
-                std::memory_order_acq_rel,
-                std::memory_order_acquire));
+                // 尾指针落后时先帮助推进，保证头指针不会越过尾指针
+                // （否则尾指针会指向已被回收的节点）
+                if (old_head == old_tail) {
+                    tail.compare_exchange_weak(
+                        old_tail, next,
+                        std::memory_order_release,
+                        std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (head.compare_exchange_weak(
+                    old_head, next,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+                    break;
+                }
+            }
+
+            // next 成为新的哨兵节点，只有成功摘除 old_head 的线程会读取它的数据
+            T result = std::move(next->data);
+            count.end();
+
+            // 旧哨兵节点待所有线程离开临界区后回到节点池
+            pool_type::instance().retire(old_head);
+
+            return result;
+        }
+
+        // 元素数量，需要汇总各分片
+        u64 size() const noexcept {
+            return count.pending();
+        }
+
+        // 累计入队、出队次数与当前长度
+        inflight_snapshot snapshot() const noexcept {
+            return count.snapshot();
+        }
+
+        // 节点池统计信息（同一元素类型的所有队列共享）
+        static node_pool_stats pool_stats() noexcept {
+            return pool_type::instance().stats();
+        }
+
+        // 头尾指针相同即为空，不读计数；push 返回前尾指针已推进，已完成的入队总能被看到
+        bool empty() const noexcept {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+    };
+
+
+    // 有界单生产者单消费者队列（环形缓冲区）
+    // 只允许一个线程入队、一个线程出队，两端都是无等待的：
+    // 生产者与消费者的位置分处不同缓存行，各自缓存对方的位置，仅在看似满（或空）时才重新读取
+    template<typename T>
+    class spsc_queue {
+    private:
+        struct slot {
+            alignas(T) std::byte storage[sizeof(T)];
+
+            T* value() noexcept {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+
+        // 生产者独占的缓存行：写入位置与缓存的读取位置
+        alignas(64) std::atomic<u64> tail{ 0 };
+        u64 cached_head = 0;
+        // 消费者独占的缓存行：读取位置与缓存的写入位置
+        alignas(64) std::atomic<u64> head{ 0 };
+        u64 cached_tail = 0;
+        alignas(64) std::unique_ptr<slot[]> slots;
+        u64 mask;
+
+        // 生产者：从 pos 开始最多可写入的数量
+        u64 writable(u64 pos, u64 n) noexcept {
+            u64 cap = mask + 1;
+            if (pos - cached_head + n > cap) {
+                cached_head = head.load(std::memory_order_acquire);
+            }
+            return std::min(n, cap - (pos - cached_head));
+        }
+
+        // 消费者：从 pos 开始最多可读取的数量
+        u64 readable(u64 pos, u64 n) noexcept {
+            if (cached_tail - pos < n) {
+                cached_tail = tail.load(std::memory_order_acquire);
+            }
+            return std::min(n, cached_tail - pos);
+        }
+
+    public:
+        // 容量向上取整为 2 的幂
+        explicit spsc_queue(u64 capacity = 1024) {
+            u64 cap = 2;
+            while (cap < capacity) cap <<= 1;
+            slots.reset(new slot[cap]);
+            mask = cap - 1;
+        }
+
+        ~spsc_queue() {
+            u64 pos = head.load(std::memory_order_relaxed);
+            u64 end = tail.load(std::memory_order_relaxed);
+            for (; pos != end; ++pos) {
+                slots[pos & mask].value()->~T();
+            }
+        }
+
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+
+        // 尝试入队（仅生产者线程），队列已满时返回 false 且不移动 value
+        bool try_push(T&& value) {
+            return push_n(&value, 1) == 1;
+        }
+
+        bool try_push(const T& value) {
+            u64 pos = tail.load(std::memory_order_relaxed);
+            if (writable(pos, 1) == 0) return false;
+            ::new (static_cast<void*>(slots[pos & mask].storage)) T(value);
+            tail.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 尝试出队（仅消费者线程），队列为空时返回 nullopt
+        std::optional<T> try_pop() {
+            u64 pos = head.load(std::memory_order_relaxed);
+            if (readable(pos, 1) == 0) return std::nullopt;
+
+            slot& s = slots[pos & mask];
+            std::optional<T> result(std::move(*s.value()));
+            s.value()->~T();
+            head.store(pos + 1, std::memory_order_release);
+            return result;
+        }
+
+        // 批量入队：全部写入后一次发布，返回实际入队数量（按顺序从 items 移出）
+        u64 push_n(T* items, u64 n) {
+            u64 pos = tail.load(std::memory_order_relaxed);
+            u64 k = writable(pos, n);
+            for (u64 i = 0; i < k; ++i) {
+                ::new (static_cast<void*>(slots[(pos + i) & mask].storage)) T(std::move(items[i]));
+            }
+            if (k > 0) tail.store(pos + k, std::memory_order_release);
+            return k;
+        }
+
+        // 批量出队：结果依次写入 out，全部读出后一次归还槽位，返回实际出队数量
+        u64 pop_n(T* out, u64 n) {
+            u64 pos = head.load(std::memory_order_relaxed);
+            u64 k = readable(pos, n);
+            for (u64 i = 0; i < k; ++i) {
+                slot& s = slots[(pos + i) & mask];
+                out[i] = std::move(*s.value());
+                s.value()->~T();
+            }
+            if (k > 0) head.store(pos + k, std::memory_order_release);
+            return k;
+        }
+
+        u64 capacity() const noexcept {
+            return mask + 1;
+        }
+
+        // 近似元素数量
+        u64 size() const noexcept {
+            u64 h = head.load(std::memory_order_acquire);
+            u64 t = tail.load(std::memory_order_acquire);
+            return t > h ? t - h : 0;
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        bool full() const noexcept {
+            return size() >= capacity();
+        }
+    };
+
+
+    // 工作窃取双端队列（Chase-Lev）
+    // 拥有者线程在底部 push/pop（后进先出），其他线程从顶部 steal（先进先出）
+    // 元素需可平凡复制，通常存放任务指针
+    template<typename T>
+    class steal_deque {
+        static_assert(std::is_trivially_copyable_v<T>, "steal_deque requires a trivially copyable T.");
+    private:
+        // 环形缓冲区，容量为 2 的幂
+        struct ring {
+            i64 capacity;
+            i64 mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+
+            explicit ring(i64 cap)
+                : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[static_cast<size_t>(cap)]) {}
+
+            T load(i64 index) const noexcept {
+                return slots[index & mask].load(std::memory_order_relaxed);
+            }
+
+            void store(i64 index, T value) noexcept {
+                slots[index & mask].store(value, std::memory_order_relaxed);
+            }
+        };
+
+        alignas(64) std::atomic<i64> top{ 0 };
+        alignas(64) std::atomic<i64> bottom{ 0 };
+        alignas(64) std::atomic<ring*> buffer;
+        // 扩容后被替换的旧缓冲区，窃取者可能仍在读取，析构时统一释放
+        std::vector<std::unique_ptr<ring>> retired;
+
+    public:
+        explicit steal_deque(i64 capacity = 256) {
+            i64 cap = 1;
+            while (cap < capacity) cap <<= 1;
+            buffer.store(new ring(cap), std::memory_order_relaxed);
+        }
+
+        ~steal_deque() {
+            delete buffer.load(std::memory_order_relaxed);
+        }
+
+        steal_deque(const steal_deque&) = delete;
+        steal_deque& operator=(const steal_deque&) = delete;
+
+        // 仅拥有者线程调用：压入底部
+        void push(T value) {
+            i64 b = bottom.load(std::memory_order_relaxed);
+            i64 t = top.load(std::memory_order_acquire);
+            ring* r = buffer.load(std::memory_order_relaxed);
+
+            // 已满则扩容为两倍
+            if (b - t > r->capacity - 1) {
+                ring* bigger = new ring(r->capacity * 2);
+                for (i64 i = t; i < b; ++i) {
+                    bigger->store(i, r->load(i));
+                }
+                retired.emplace_back(r);
+                buffer.store(bigger, std::memory_order_release);
+                r = bigger;
+            }
+
+            r->store(b, value);
+            bottom.store(b + 1, std::memory_order_release);
+        }
+
+        // 仅拥有者线程调用：从底部弹出
+        std::optional<T> pop() {
+            i64 b = bottom.load(std::memory_order_relaxed) - 1;
+            ring* r = buffer.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_seq_cst);
+            i64 t = top.load(std::memory_order_seq_cst);
+
+            if (t > b) {
+                // 队列为空
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            T value = r->load(b);
+            if (t == b) {
+                // 最后一个元素，与窃取者竞争
+                bool won = top.compare_exchange_strong(
+                    t, t + 1,
+                    std::memory_order_seq_cst,
+                    std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                if (!won) return std::nullopt;
+            }
+            return value;
+        }
+
+        // 任意线程调用：从顶部窃取
+        std::optional<T> steal() {
+            i64 t = top.load(std::memory_order_seq_cst);
+            i64 b = bottom.load(std::memory_order_seq_cst);
+
+            if (t >= b) return std::nullopt;
+
+            ring* r = buffer.load(std::memory_order_acquire);
+            T value = r->load(t);
+            if (!top.compare_exchange_strong(
+                t, t + 1,
+                std::memory_order_seq_cst,
+                std::memory_order_relaxed)) {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        u64 size() const noexcept {
+            i64 b = bottom.load(std::memory_order_relaxed);
+            i64 t = top.load(std::memory_order_relaxed);
+            return b > t ? static_cast<u64>(b - t) : 0;
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+    };
+
+
+    // 有界无锁多生产者多消费者队列（Vyukov 环形缓冲区）
+    // 每个槽位带序号，生产者与消费者各自 CAS 推进位置，不分配内存
+    template<typename T>
+    class bounded_queue {
+    private:
+        struct cell {
+            std::atomic<u64> sequence;
+            alignas(T) std::byte storage[sizeof(T)];
+
+            T* value() noexcept {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+
+        // 生产者与消费者位置分处不同缓存行
+        alignas(64) std::atomic<u64> enqueue_pos{ 0 };
+        alignas(64) std::atomic<u64> dequeue_pos{ 0 };
+        alignas(64) std::unique_ptr<cell[]> cells;
+        u64 mask;
+        // 阻塞操作的等待点
+        event_count not_empty;
+        event_count not_full;
+
+        // 从 pos 开始统计最多 n 个连续可写（或可读）的槽位
+        u64 ready_cells(u64 pos, u64 n, u64 offset) const noexcept {
+            u64 k = 0;
+            while (k < n &&
+                cells[(pos + k) & mask].sequence.load(std::memory_order_acquire) == pos + k + offset) {
+                ++k;
+            }
+            return k;
+        }
+
+        // 认领 [pos, pos + k) 这段位置，offset 为 0 表示写入，为 1 表示读取
+        u64 claim(std::atomic<u64>& position, u64 n, u64 offset, u64& pos) noexcept {
+            pos = position.load(std::memory_order_relaxed);
+            while (true) {
+                u64 k = ready_cells(pos, n, offset);
+                if (k == 0) {
+                    // 首个槽位尚未就绪：若被其他线程抢先则重试，否则队列已满（或为空）
+                    u64 seq = cells[pos & mask].sequence.load(std::memory_order_acquire);
+                    if (static_cast<i64>(seq - (pos + offset)) < 0) return 0;
+                    pos = position.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (position.compare_exchange_weak(
+                    pos, pos + k,
+                    std::memory_order_relaxed,
+                    std::memory_order_relaxed)) {
+                    return k;
+                }
+            }
+        }
+
+    public:
+        // 容量向上取整为 2 的幂
+        explicit bounded_queue(u64 capacity = 1024) {
+            u64 cap = 2;
+            while (cap < capacity) cap <<= 1;
+            cells.reset(new cell[cap]);
+            mask = cap - 1;
+            for (u64 i = 0; i < cap; ++i) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~bounded_queue() {
+            while (try_pop().has_value());
+        }
+
+        bounded_queue(const bounded_queue&) = delete;
+        bounded_queue& operator=(const bounded_queue&) = delete;
+
+        // 尝试入队，队列已满时返回 false 且不移动 value
+        bool try_push(T&& value) {
+            return push_n(&value, 1) == 1;
+        }
+
+        bool try_push(const T& value) {
+            T copy(value);
+            return try_push(std::move(copy));
+        }
+
+        // 尝试出队，队列为空时返回 nullopt
+        std::optional<T> try_pop() {
+            u64 pos;
+            if (claim(dequeue_pos, 1, 1, pos) == 0) return std::nullopt;
 
-            T result = std::move(expected_next->data);
-            count.fetch_sub(1, std::memory_order_relaxed);
+            cell& c = cells[pos & mask];
+            std::optional<T> result(std::move(*c.value()));
+            c.value()->~T();
+            c.sequence.store(pos + mask + 1, std::memory_order_release);
+            not_full.notify_one();
+            return result;
+        }
+
+        // 批量入队：一次 CAS 认领多个槽位，返回实际入队数量（按顺序从 items 移出）
+        u64 push_n(T* items, u64 n) {
+            u64 pos;
+            u64 k = claim(enqueue_pos, n, 0, pos);
+            for (u64 i = 0; i < k; ++i) {
+                cell& c = cells[(pos + i) & mask];
+                ::new (static_cast<void*>(c.storage)) T(std::move(items[i]));
+                c.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            if (k == 1) not_empty.notify_one();
+            else if (k > 1) not_empty.notify_all();
+            return k;
+        }
 
-            // 延迟删除旧节点
-            static thread_local std::vector<node*> garbage;
-            garbage.push_back(old_head);
+        // 批量出队：结果依次写入 out，返回实际出队数量
+        u64 pop_n(T* out, u64 n) {
+            u64 pos;
+            u64 k = claim(dequeue_pos, n, 1, pos);
+            for (u64 i = 0; i < k; ++i) {
+                cell& c = cells[(pos + i) & mask];
+                out[i] = std::move(*c.value());
+                c.value()->~T();
+                c.sequence.store(pos + i + mask + 1, std::memory_order_release);
+            }
+            if (k == 1) not_full.notify_one();
+            else if (k > 1) not_full.notify_all();
+            return k;
+        }
+
+        // 阻塞入队，直到有空闲槽位
+        void push(T value) {
+            while (!try_push(std::move(value))) {
+                event_count::key key = not_full.prepare_wait();
+                if (!full()) {
+                    not_full.cancel_wait();
+                    continue;
+                }
+                not_full.commit_wait(key);
+            }
+        }
 
-            if (garbage.size() > 64) {  // 批量清理
-                for (auto p : garbage) delete p;
-                garbage.clear();
+        // 阻塞出队，直到有元素
+        T pop() {
+            while (true) {
+                if (auto value = try_pop()) return std::move(*value);
+                event_count::key key = not_empty.prepare_wait();
+                if (!empty()) {
+                    not_empty.cancel_wait();
+                    continue;
+                }
+                not_empty.commit_wait(key);
             }
+        }
+
+        u64 capacity() const noexcept {
+            return mask + 1;
+        }
+
+        // 近似元素数量
+        u64 size() const noexcept {
+            u64 tail = enqueue_pos.load(std::memory_order_acquire);
+            u64 head = dequeue_pos.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        bool full() const noexcept {
+            return size() >= capacity();
+        }
+    };
 
+
+    // 按键值排序的队列（键值最小者先出，键值相同时先进先出），用于截止时间优先调度
+    // 互斥锁保护的二叉堆
+    template<typename T, typename Key>
+    class deadline_queue {
+    private:
+        struct entry {
+            Key key;
+            u64 sequence;
+            T value;
+        };
+
+        // 堆顶为键值最小、序号最小的元素
+        static bool later(const entry& a, const entry& b) noexcept {
+            if (b.key < a.key) return true;
+            if (a.key < b.key) return false;
+            return a.sequence > b.sequence;
+        }
+
+        mutable std::mutex mutex;
+        std::vector<entry> heap;
+        u64 next_sequence = 0;
+        std::atomic<u64> count{ 0 };
+
+    public:
+        void push(Key key, T&& value) {
+            std::lock_guard<std::mutex> lock(mutex);
+            heap.push_back(entry{ key, next_sequence++, std::move(value) });
+            std::push_heap(heap.begin(), heap.end(), later);
+            count.store(heap.size(), std::memory_order_relaxed);
+        }
+
+        std::optional<T> pop() {
+            // 空队列不加锁
+            if (count.load(std::memory_order_relaxed) == 0) return std::nullopt;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (heap.empty()) return std::nullopt;
+            std::pop_heap(heap.begin(), heap.end(), later);
+            std::optional<T> result(std::move(heap.back().value));
+            heap.pop_back();
+            count.store(heap.size(), std::memory_order_relaxed);
             return result;
         }
 
@@ -125,7 +648,338 @@ namespace tools::thread::data {
         }
     };
 
+    namespace detail {
+        // 可平凡复制且 std::atomic<T> 始终无锁
+        template<typename T, bool = std::is_trivially_copyable_v<T>>
+        struct lock_free_value : std::false_type {};
 
+        template<typename T>
+        struct lock_free_value<T, true> : std::bool_constant<std::atomic<T>::is_always_lock_free> {};
+    }
 
+    // 并发哈希表：分段锁写入，无锁读取
+    // 键按哈希分到多个分段，写操作只锁所在分段；find / contains / visit 不加锁，在 epoch_guard 内遍历链表
+    // 值可以无锁原子访问时（如整数、指针）覆盖写直接原子存储，不分配新节点；
+    // 其他类型写入时以新节点替换旧节点，读者总能看到完整的值
+    // 被替换的节点与桶数组经纪元回收延迟释放；扩容时复制分段内的节点，键和值须可复制
+    template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class concurrent_map {
+    private:
+        static constexpr bool atomic_value = detail::lock_free_value<V>::value;
+        using stored_type = std::conditional_t<atomic_value, std::atomic<V>, V>;
+
+        struct node {
+            u64 hash;
+            K key;
+            stored_type value;
+            std::atomic<node*> next{ nullptr };
+
+            template<typename Key, typename Value>
+            node(u64 hash, Key&& key, Value&& value)
+                : hash(hash), key(std::forward<Key>(key)), value(std::forward<Value>(value)) {}
+
+            V load() const {
+                if constexpr (atomic_value) return value.load(std::memory_order_acquire);
+                else return value;
+            }
+        };
+
+        using pool_type = node_pool<node>;
+
+        // 桶数组，容量为 2 的幂，链表头紧跟在对象之后（一次分配）
+        struct table {
+            u64 mask;
+
+            std::atomic<node*>* heads() noexcept {
+                return reinterpret_cast<std::atomic<node*>*>(this + 1);
+            }
+
+            static table* create(u64 capacity) {
+                void* p = ::operator new(sizeof(table) + capacity * sizeof(std::atomic<node*>));
+                table* t = ::new (p) table{ capacity - 1 };
+                for (u64 i = 0; i < capacity; ++i) ::new (static_cast<void*>(t->heads() + i)) std::atomic<node*>(nullptr);
+                return t;
+            }
+
+            static void release(void* p) noexcept {
+                ::operator delete(p);
+            }
+        };
+
+        struct alignas(64) shard {
+            std::mutex mutex;
+            std::atomic<table*> buckets{ nullptr };
+            std::atomic<u64> count{ 0 };
+        };
+
+        static constexpr u64 initial_buckets = 8;
+
+        std::unique_ptr<shard[]> shards;
+        u64 shard_mask = 0;
+        u32 shard_shift = 64;
+        Hash hasher;
+        KeyEqual equal;
+
+        // 打散哈希值（std::hash 对整数通常是恒等映射），高位选分段，低位选桶
+        u64 hash_of(const K& key) const {
+            u64 h = static_cast<u64>(hasher(key));
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        shard& shard_of(u64 h) const {
+            return shards[shard_shift >= 64 ? 0 : (h >> shard_shift) & shard_mask];
+        }
+
+        // 在链表中查找键，返回指向该节点的链接与节点本身
+        std::pair<std::atomic<node*>*, node*> locate(table* t, u64 h, const K& key) const {
+            std::atomic<node*>* link = &t->heads()[h & t->mask];
+            node* n = link->load(std::memory_order_acquire);
+            while (n) {
+                if (n->hash == h && equal(n->key, key)) return { link, n };
+                link = &n->next;
+                n = link->load(std::memory_order_acquire);
+            }
+            return { link, nullptr };
+        }
+
+        // 无锁查找，须在 epoch_guard 内调用
+        node* find_node(const K& key) const {
+            u64 h = hash_of(key);
+            table* t = shard_of(h).buckets.load(std::memory_order_acquire);
+            for (node* n = t->heads()[h & t->mask].load(std::memory_order_acquire); n;
+                n = n->next.load(std::memory_order_acquire)) {
+                if (n->hash == h && equal(n->key, key)) return n;
+            }
+            return nullptr;
+        }
+
+        // 在链表头部插入新节点（持有分段锁），负载超过 1 时扩容
+        void link_front(shard& s, table* t, node* created) {
+            std::atomic<node*>& head = t->heads()[created->hash & t->mask];
+            created->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            head.store(created, std::memory_order_release);
+
+            u64 size = s.count.load(std::memory_order_relaxed) + 1;
+            s.count.store(size, std::memory_order_relaxed);
+            if (size > t->mask + 1) grow(s, t);
+        }
+
+        // 以新节点替换 old（持有分段锁）
+        void replace(std::atomic<node*>* link, node* old, node* created) {
+            created->next.store(old->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            link->store(created, std::memory_order_release);
+            reclaim::epoch_guard guard;
+            pool_type::instance().retire(old);
+        }
+
+        // 容量翻倍：复制节点到新桶数组后整体发布，正在读旧数组的线程不受影响
+        void grow(shard& s, table* old) {
+            table* bigger = table::create((old->mask + 1) * 2);
+            std::vector<node*> retired;
+            retired.reserve(s.count.load(std::memory_order_relaxed));
+            try {
+                for (u64 i = 0; i <= old->mask; ++i) {
+                    for (node* n = old->heads()[i].load(std::memory_order_relaxed); n;
+                        n = n->next.load(std::memory_order_relaxed)) {
+                        node* copy = pool_type::instance().create(n->hash, n->key, n->load());
+                        std::atomic<node*>& head = bigger->heads()[n->hash & bigger->mask];
+                        copy->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                        head.store(copy, std::memory_order_relaxed);
+                        retired.push_back(n);
+                    }
+                }
+            }
+            catch (...) {
+                // 复制失败时保留旧数组
+                destroy_table(bigger);
+                return;
+            }
+
+            s.buckets.store(bigger, std::memory_order_release);
+            reclaim::epoch_guard guard;
+            for (node* n : retired) pool_type::instance().retire(n);
+            reclaim::retire(old, &table::release);
+        }
+
+        // 独占时释放桶数组及其节点
+        static void destroy_table(table* t) noexcept {
+            for (u64 i = 0; i <= t->mask; ++i) {
+                node* n = t->heads()[i].load(std::memory_order_relaxed);
+                while (n) {
+                    node* next = n->next.load(std::memory_order_relaxed);
+                    pool_type::instance().destroy(n);
+                    n = next;
+                }
+            }
+            table::release(t);
+        }
+
+    public:
+        // shard_count：分段数（取 2 的幂），0 表示按硬件线程数的 4 倍
+        explicit concurrent_map(u64 shard_count = 0, const Hash& hash = Hash(), const KeyEqual& key_equal = KeyEqual())
+            : hasher(hash), equal(key_equal) {
+            if (shard_count == 0) {
+                shard_count = std::max<u64>(1, std::thread::hardware_concurrency()) * 4;
+            }
+            u64 count = 1;
+            u32 bits = 0;
+            while (count < shard_count) {
+                count <<= 1;
+                ++bits;
+            }
+            shards.reset(new shard[count]);
+            shard_mask = count - 1;
+            shard_shift = 64 - bits;
+            for (u64 i = 0; i < count; ++i) {
+                shards[i].buckets.store(table::create(initial_buckets), std::memory_order_relaxed);
+            }
+        }
+
+        concurrent_map(const concurrent_map&) = delete;
+        concurrent_map& operator=(const concurrent_map&) = delete;
+
+        ~concurrent_map() {
+            for (u64 i = 0; i <= shard_mask; ++i) {
+                destroy_table(shards[i].buckets.load(std::memory_order_relaxed));
+            }
+        }
+
+        // 查找并复制值（不加锁）
+        std::optional<V> find(const K& key) const {
+            reclaim::epoch_guard guard;
+            if (node* n = find_node(key)) return n->load();
+            return std::nullopt;
+        }
+
+        bool contains(const K& key) const {
+            reclaim::epoch_guard guard;
+            return find_node(key) != nullptr;
+        }
+
+        // 不复制地读取值：找到时调用 f(const V&) 并返回 true（不加锁，f 不应长时间运行）
+        template<typename F>
+        bool visit(const K& key, F&& f) const {
+            reclaim::epoch_guard guard;
+            node* n = find_node(key);
+            if (!n) return false;
+            if constexpr (atomic_value) f(static_cast<const V&>(n->load()));
+            else f(static_cast<const V&>(n->value));
+            return true;
+        }
+
+        // 键不存在时插入，返回是否插入
+        bool insert(K key, V value) {
+            u64 h = hash_of(key);
+            shard& s = shard_of(h);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            table* t = s.buckets.load(std::memory_order_relaxed);
+            if (locate(t, h, key).second) return false;
+            link_front(s, t, pool_type::instance().create(h, std::move(key), std::move(value)));
+            return true;
+        }
+
+        // 插入或覆盖，返回是否为新插入
+        bool upsert(K key, V value) {
+            u64 h = hash_of(key);
+            shard& s = shard_of(h);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            table* t = s.buckets.load(std::memory_order_relaxed);
+            auto [link, old] = locate(t, h, key);
+            if (old) {
+                if constexpr (atomic_value) old->value.store(value, std::memory_order_release);
+                else replace(link, old, pool_type::instance().create(h, std::move(key), std::move(value)));
+                return false;
+            }
+            link_front(s, t, pool_type::instance().create(h, std::move(key), std::move(value)));
+            return true;
+        }
+
+        // 键存在时以 f(const V&) 的结果替换值（持有分段锁），返回是否存在
+        template<typename F>
+        bool update(const K& key, F&& f) {
+            u64 h = hash_of(key);
+            shard& s = shard_of(h);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto [link, old] = locate(s.buckets.load(std::memory_order_relaxed), h, key);
+            if (!old) return false;
+            if constexpr (atomic_value) {
+                old->value.store(f(static_cast<const V&>(old->load())), std::memory_order_release);
+            }
+            else {
+                replace(link, old, pool_type::instance().create(h, old->key, f(static_cast<const V&>(old->value))));
+            }
+            return true;
+        }
+
+        // 删除键，返回是否存在
+        bool erase(const K& key) {
+            u64 h = hash_of(key);
+            shard& s = shard_of(h);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto [link, old] = locate(s.buckets.load(std::memory_order_relaxed), h, key);
+            if (!old) return false;
+            link->store(old->next.load(std::memory_order_relaxed), std::memory_order_release);
+            s.count.store(s.count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            reclaim::epoch_guard guard;
+            pool_type::instance().retire(old);
+            return true;
+        }
+
+        // 逐个分段遍历，f(const K&, const V&)；不是整体快照，遍历期间的修改可能可见也可能不可见
+        template<typename F>
+        void for_each(F&& f) const {
+            for (u64 i = 0; i <= shard_mask; ++i) {
+                reclaim::epoch_guard guard;
+                table* t = shards[i].buckets.load(std::memory_order_acquire);
+                for (u64 b = 0; b <= t->mask; ++b) {
+                    for (node* n = t->heads()[b].load(std::memory_order_acquire); n;
+                        n = n->next.load(std::memory_order_acquire)) {
+                        if constexpr (atomic_value) f(static_cast<const K&>(n->key), static_cast<const V&>(n->load()));
+                        else f(static_cast<const K&>(n->key), static_cast<const V&>(n->value));
+                    }
+                }
+            }
+        }
+
+        // 删除全部元素
+        void clear() {
+            for (u64 i = 0; i <= shard_mask; ++i) {
+                shard& s = shards[i];
+                std::lock_guard<std::mutex> lock(s.mutex);
+                table* old = s.buckets.load(std::memory_order_relaxed);
+                s.buckets.store(table::create(initial_buckets), std::memory_order_release);
+                s.count.store(0, std::memory_order_relaxed);
+                reclaim::epoch_guard guard;
+                for (u64 b = 0; b <= old->mask; ++b) {
+                    for (node* n = old->heads()[b].load(std::memory_order_relaxed); n;
+                        n = n->next.load(std::memory_order_relaxed)) {
+                        pool_type::instance().retire(n);
+                    }
+                }
+                reclaim::retire(old, &table::release);
+            }
+        }
+
+        u64 size() const noexcept {
+            u64 total = 0;
+            for (u64 i = 0; i <= shard_mask; ++i) {
+                total += shards[i].count.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        u64 shard_count() const noexcept {
+            return shard_mask + 1;
+        }
+    };
 
 }
\ No newline at end of file
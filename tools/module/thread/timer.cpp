@@ -0,0 +1,298 @@
+#include "timer.hpp"
+
+#include "affinity.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace tools::thread {
+    namespace {
+        // 各层在 heads 中的起始位置
+        constexpr u32 level_offset(u32 level) noexcept {
+            return level == 0 ? 0 : (1u << 8) + (level - 1) * (1u << 6);
+        }
+    }
+
+    timer_wheel::timer_wheel(pool* workers, const timer_options& options)
+        : workers(workers),
+        resolution(std::max(clock_duration(1), std::chrono::duration_cast<clock_duration>(options.resolution))),
+        start(tools::time::time_now()),
+        heads(level_offset(level_count), no_node),
+        thread_name(options.thread_name) {
+        nodes.reserve(options.reserve);
+        free_nodes.reserve(options.reserve);
+        thread = std::thread(&timer_wheel::run, this);
+    }
+
+    timer_wheel::~timer_wheel() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_one();
+        if (thread.joinable()) thread.join();
+    }
+
+    u64 timer_wheel::to_ticks(clock_duration d) const {
+        if (d <= clock_duration::zero()) return 1;
+        return std::max<u64>(1, static_cast<u64>((d + resolution - clock_duration(1)) / resolution));
+    }
+
+    timer_wheel::timer_id timer_wheel::arm(tools::time::time_point deadline, u64 period, pool* target,
+        task&& callback, std::shared_ptr<task> periodic) {
+        // 向上取整，保证不早于 deadline 触发
+        clock_duration offset = deadline - start;
+        u64 expires = offset <= clock_duration::zero() ? 0
+            : static_cast<u64>((offset + resolution - clock_duration(1)) / resolution);
+
+        bool notify = false;
+        timer_id id = invalid_timer;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // 轮为空时直接跳到当前时间，定时线程无需逐格追赶
+            if (counters.active == 0) {
+                u64 now_tick = static_cast<u64>((tools::time::time_now() - start) / resolution);
+                current_tick = std::max(current_tick, now_tick);
+            }
+
+            u32 index = allocate_node();
+            node& n = nodes[index];
+            n.expires = std::max(expires, current_tick + 1);
+            n.period = period;
+            n.target = target;
+            n.callback = std::move(callback);
+            n.periodic = std::move(periodic);
+            link(index);
+            ++counters.active;
+
+            id = (static_cast<u64>(n.generation) << 32) | index;
+            notify = n.expires < wake_tick;
+        }
+        if (notify) wake.notify_one();
+        return id;
+    }
+
+    bool timer_wheel::cancel(timer_id id) {
+        u32 index = static_cast<u32>(id);
+        u32 generation = static_cast<u32>(id >> 32);
+
+        // 回调在锁外析构
+        task callback;
+        std::shared_ptr<task> periodic;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (index >= nodes.size()) return false;
+            node& n = nodes[index];
+            if (n.generation != generation || n.slot == no_slot) return false;
+
+            unlink(index);
+            callback = std::move(n.callback);
+            periodic = std::move(n.periodic);
+            free_node(index);
+            --counters.active;
+            ++counters.cancelled;
+        }
+        return true;
+    }
+
+    u64 timer_wheel::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return counters.active;
+    }
+
+    timer_stats timer_wheel::stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return counters;
+    }
+
+    u32 timer_wheel::allocate_node() {
+        if (!free_nodes.empty()) {
+            u32 index = free_nodes.back();
+            free_nodes.pop_back();
+            return index;
+        }
+        nodes.emplace_back();
+        return static_cast<u32>(nodes.size() - 1);
+    }
+
+    void timer_wheel::free_node(u32 index) {
+        node& n = nodes[index];
+        n.callback.reset();
+        n.periodic.reset();
+        n.target = nullptr;
+        n.slot = no_slot;
+        // 代数递增使旧编号失效，跳过 0 以免与无效编号混淆
+        if (++n.generation == 0) n.generation = 1;
+        free_nodes.push_back(index);
+    }
+
+    void timer_wheel::link(u32 index) {
+        node& n = nodes[index];
+        u64 delta = n.expires - current_tick;
+
+        u32 level = 0;
+        u32 slot = 0;
+        if (delta < root_size) {
+            slot = static_cast<u32>(n.expires & (root_size - 1));
+        }
+        else {
+            // 超出范围的定时器放在最高层轮最远的格，降级时按真实到期时间重新放置
+            u64 placed = delta < max_ticks ? n.expires : current_tick + max_ticks - 1;
+            level = 1;
+            while (level + 1 < level_count && (placed - current_tick) >= (u64(1) << (root_bits + level * level_bits))) {
+                ++level;
+            }
+            u32 shift = root_bits + (level - 1) * level_bits;
+            slot = static_cast<u32>((placed >> shift) & (level_size - 1));
+        }
+
+        u32 position = level_offset(level) + slot;
+        n.slot = position;
+        n.prev = no_node;
+        n.next = heads[position];
+        if (n.next != no_node) nodes[n.next].prev = index;
+        heads[position] = index;
+        occupied[level][slot / 64] |= u64(1) << (slot % 64);
+    }
+
+    void timer_wheel::unlink(u32 index) {
+        node& n = nodes[index];
+        if (n.prev != no_node) nodes[n.prev].next = n.next;
+        else heads[n.slot] = n.next;
+        if (n.next != no_node) nodes[n.next].prev = n.prev;
+
+        if (heads[n.slot] == no_node) {
+            u32 level = 0;
+            while (level + 1 < level_count && n.slot >= level_offset(level + 1)) ++level;
+            u32 slot = n.slot - level_offset(level);
+            occupied[level][slot / 64] &= ~(u64(1) << (slot % 64));
+        }
+        n.slot = no_slot;
+    }
+
+    void timer_wheel::cascade(u32 level, u32 slot) {
+        u32 position = level_offset(level) + slot;
+        u32 index = heads[position];
+        heads[position] = no_node;
+        occupied[level][slot / 64] &= ~(u64(1) << (slot % 64));
+        while (index != no_node) {
+            u32 next = nodes[index].next;
+            link(index);
+            ++counters.cascaded;
+            index = next;
+        }
+    }
+
+    void timer_wheel::advance(u64 tick, std::vector<due_task>& due) {
+        while (current_tick < tick) {
+            u64 t = ++current_tick;
+
+            // 低层轮转完一圈时从上一层取下一格的定时器
+            if ((t & (root_size - 1)) == 0) {
+                for (u32 level = 1; level < level_count; ++level) {
+                    u32 shift = root_bits + (level - 1) * level_bits;
+                    u32 slot = static_cast<u32>((t >> shift) & (level_size - 1));
+                    cascade(level, slot);
+                    if (slot != 0) break;
+                }
+            }
+
+            u32 slot = static_cast<u32>(t & (root_size - 1));
+            u32 index = heads[slot];
+            heads[slot] = no_node;
+            occupied[0][slot / 64] &= ~(u64(1) << (slot % 64));
+
+            while (index != no_node) {
+                node& n = nodes[index];
+                u32 next = n.next;
+                n.slot = no_slot;
+                ++counters.fired;
+
+                if (n.periodic) {
+                    due.push_back({ n.target, task([callback = n.periodic] { (*callback)(); }) });
+                    // 固定频率，落后时跳过错过的周期
+                    u64 expires = n.expires + n.period;
+                    if (expires <= t) expires += n.period * ((t - expires) / n.period + 1);
+                    n.expires = expires;
+                    link(index);
+                }
+                else {
+                    due.push_back({ n.target, std::move(n.callback) });
+                    free_node(index);
+                    --counters.active;
+                }
+                index = next;
+            }
+        }
+    }
+
+    u64 timer_wheel::next_wake_tick() const {
+        if (counters.active == 0) return ~u64(0);
+
+        // 最低层轮中下一个非空格
+        u64 result = ~u64(0);
+        u32 from = static_cast<u32>((current_tick + 1) & (root_size - 1));
+        for (u32 step = 0; step <= root_size / 64; ++step) {
+            u32 word = ((from / 64) + step) % (root_size / 64);
+            u64 bits = occupied[0][word];
+            if (step == 0) bits &= ~u64(0) << (from % 64);
+            if (bits) {
+                u32 slot = word * 64 + static_cast<u32>(std::countr_zero(bits));
+                u32 distance = (slot - from) & (root_size - 1);
+                result = current_tick + 1 + distance;
+                break;
+            }
+        }
+
+        // 高层轮非空时在下一次降级时醒来
+        for (u32 level = 1; level < level_count; ++level) {
+            if (occupied[level][0]) {
+                result = std::min(result, (current_tick | (root_size - 1)) + 1);
+                break;
+            }
+        }
+        return result;
+    }
+
+    void timer_wheel::run() {
+        set_current_thread_name(thread_name);
+
+        std::vector<due_task> due;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop) {
+            u64 now_tick = static_cast<u64>((tools::time::time_now() - start) / resolution);
+            if (counters.active == 0) {
+                current_tick = std::max(current_tick, now_tick);
+            }
+            else {
+                advance(now_tick, due);
+            }
+
+            if (!due.empty()) {
+                lock.unlock();
+                for (auto& entry : due) {
+                    // 线程池拒绝时任务保持不变，在定时线程上执行
+                    if (entry.target && entry.target->insert(std::move(entry.callback))) continue;
+                    try {
+                        entry.callback();
+                    }
+                    catch (...) {
+
+                    }
+                }
+                due.clear();
+                lock.lock();
+                continue;
+            }
+
+            wake_tick = next_wake_tick();
+            if (wake_tick == ~u64(0)) {
+                wake.wait(lock);
+            }
+            else {
+                wake.wait_until(lock, start + resolution * static_cast<i64>(wake_tick));
+            }
+            wake_tick = ~u64(0);
+        }
+    }
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "../../base.hpp"
+
+// 线程池
+#include "pool.hpp"
+
+// 时间
+#include "../time/time.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tools::thread {
+    // 定时器轮配置
+    struct timer_options {
+        // 时间精度（一格的长度），定时器不会早于到期时间触发，最多晚一格
+        tools::time::us resolution{ 1000 };
+        // 预先分配的定时器数量
+        u64 reserve = 0;
+        // 定时线程名称
+        std::string thread_name = "tools_timer";
+    };
+
+    // 定时器轮统计信息
+    struct timer_stats {
+        // 等待触发的定时器数
+        u64 active = 0;
+        // 已触发次数（周期任务每次触发计一次）
+        u64 fired = 0;
+        // 已取消的定时器数
+        u64 cancelled = 0;
+        // 从高层轮降级到低层轮的次数
+        u64 cascaded = 0;
+    };
+
+    // 分层时间轮：一个定时线程推进时间，到期的回调交给线程池执行
+    // 四层轮共 256 * 64 * 64 * 64 格，1 ms 精度时覆盖约 18.6 小时，更远的定时器在最高层轮中循环等待
+    // 添加与取消都是 O(1)；未指定线程池或线程池拒绝时回调在定时线程上执行，应保持简短
+    class timer_wheel {
+    public:
+        // 定时器编号，0 表示无效
+        using timer_id = u64;
+        static constexpr timer_id invalid_timer = 0;
+
+        explicit timer_wheel(pool* workers = nullptr, const timer_options& options = timer_options());
+
+        timer_wheel(const timer_wheel&) = delete;
+        timer_wheel& operator=(const timer_wheel&) = delete;
+
+        // 停止定时线程，未触发的定时器被丢弃
+        ~timer_wheel();
+
+        // 在 deadline 时执行
+        template<typename F>
+        timer_id schedule_at(tools::time::time_point deadline, F&& f) {
+            return arm(deadline, 0, workers, make_callback(std::forward<F>(f)), nullptr);
+        }
+
+        // 在 deadline 时交给指定线程池执行
+        template<typename F>
+        timer_id schedule_at(pool& target, tools::time::time_point deadline, F&& f) {
+            return arm(deadline, 0, &target, make_callback(std::forward<F>(f)), nullptr);
+        }
+
+        // 延迟 delay 后执行
+        template<typename Rep, typename Period, typename F>
+        timer_id schedule_after(std::chrono::duration<Rep, Period> delay, F&& f) {
+            return schedule_at(tools::time::time_now() + to_clock(delay), std::forward<F>(f));
+        }
+
+        // 每隔 period 执行一次，首次在 period 后；按固定频率触发，落后时跳过错过的周期
+        // 回调耗时超过周期时可能在多个工作线程上同时执行
+        template<typename Rep, typename Period, typename F>
+        timer_id schedule_every(std::chrono::duration<Rep, Period> period, F&& f) {
+            auto callback = std::make_shared<task>(make_callback(std::forward<F>(f)));
+            auto interval = to_clock(period);
+            return arm(tools::time::time_now() + interval, to_ticks(interval), workers, task(), std::move(callback));
+        }
+
+        // 取消定时器，在触发前取消成功返回 true；周期任务取消后不再触发
+        bool cancel(timer_id id);
+
+        // 等待触发的定时器数
+        u64 size() const;
+
+        // 统计信息
+        timer_stats stats() const;
+
+    private:
+        using clock_duration = tools::time::time_point::duration;
+
+        // 各层轮的格数（位数）
+        static constexpr u32 level_count = 4;
+        static constexpr u32 root_bits = 8;
+        static constexpr u32 level_bits = 6;
+        static constexpr u32 root_size = 1u << root_bits;
+        static constexpr u32 level_size = 1u << level_bits;
+        static constexpr u64 max_ticks = u64(1) << (root_bits + level_bits * (level_count - 1));
+        static constexpr u32 no_slot = ~u32(0);
+        static constexpr u32 no_node = ~u32(0);
+
+        // 定时器节点：按下标组成每格的双向链表，下标与代数组成定时器编号
+        struct node {
+            u64 expires = 0;
+            u64 period = 0;
+            pool* target = nullptr;
+            task callback;
+            std::shared_ptr<task> periodic;
+            u32 prev = no_node;
+            u32 next = no_node;
+            u32 slot = no_slot;
+            u32 generation = 1;
+        };
+
+        // 一次到期需要派发的回调
+        struct due_task {
+            pool* target;
+            task callback;
+        };
+
+        template<typename F>
+        static task make_callback(F&& f) {
+            if constexpr (std::is_same_v<std::decay_t<F>, task>) {
+                return task(std::forward<F>(f));
+            }
+            else {
+                return task([f = std::forward<F>(f)]() mutable { f(); });
+            }
+        }
+
+        template<typename Rep, typename Period>
+        static clock_duration to_clock(std::chrono::duration<Rep, Period> d) {
+            return std::chrono::duration_cast<clock_duration>(d);
+        }
+
+        u64 to_ticks(clock_duration d) const;
+
+        timer_id arm(tools::time::time_point deadline, u64 period, pool* target, task&& callback, std::shared_ptr<task> periodic);
+
+        // 以下须持有 mutex
+        u32 allocate_node();
+        void free_node(u32 index);
+        void link(u32 index);
+        void unlink(u32 index);
+        void cascade(u32 level, u32 slot);
+        void advance(u64 tick, std::vector<due_task>& due);
+        u64 next_wake_tick() const;
+
+        void run();
+
+        pool* workers;
+        clock_duration resolution;
+        tools::time::time_point start;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        std::vector<node> nodes;
+        std::vector<u32> free_nodes;
+        // 各格链表头，按层依次排列
+        std::vector<u32> heads;
+        // 各层非空格的位图
+        std::array<std::array<u64, root_size / 64>, level_count> occupied{};
+        // 已处理到的格
+        u64 current_tick = 0;
+        // 定时线程计划醒来的格
+        u64 wake_tick = ~u64(0);
+        timer_stats counters;
+        bool stop = false;
+        std::string thread_name;
+        std::thread thread;
+    };
+}
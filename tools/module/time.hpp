@@ -1,4 +1,7 @@
 #pragma once
 
 // 
-#include "time/time.hpp"
\ No newline at end of file
+#include "time/time.hpp"
+
+// 延迟直方图
+#include "time/histogram.hpp"
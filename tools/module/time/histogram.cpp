@@ -0,0 +1,102 @@
+#include "histogram.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <thread>
+
+namespace tools::time {
+    namespace {
+        // 以合适的单位输出时长
+        void write_duration(std::ostream& out, f64 ns) {
+            if (ns >= 1e9) out << ns / 1e9 << " s";
+            else if (ns >= 1e6) out << ns / 1e6 << " ms";
+            else if (ns >= 1e3) out << ns / 1e3 << " us";
+            else out << ns << " ns";
+        }
+    }
+
+    void latency_snapshot::merge(const latency_snapshot& other) noexcept {
+        for (u64 i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        min_value = std::min(min_value, other.min_value);
+        max_value = std::max(max_value, other.max_value);
+    }
+
+    tools::time::ns latency_snapshot::percentile(f64 percentile) const noexcept {
+        if (total == 0) return tools::time::ns(0.0);
+        // 最近秩：第 ceil(p% x n) 个值，至少为第 1 个
+        f64 clamped = std::clamp(percentile, 0.0, 100.0);
+        u64 rank = static_cast<u64>(std::ceil(clamped / 100.0 * static_cast<f64>(total)));
+        rank = std::clamp<u64>(rank, 1, total);
+
+        u64 seen = 0;
+        for (u64 i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                u64 value = std::clamp(histogram_layout::bucket_upper(i), min_value, max_value);
+                return tools::time::ns(static_cast<f64>(value));
+            }
+        }
+        return max();
+    }
+
+    std::string latency_snapshot::summary() const {
+        std::ostringstream out;
+        out << "n " << total;
+        const std::pair<const char*, f64> points[] = { { "p50", 50 }, { "p99", 99 }, { "p99.9", 99.9 } };
+        for (auto& [name, p] : points) {
+            out << "  " << name << ' ';
+            write_duration(out, percentile(p).count());
+        }
+        out << "  max ";
+        write_duration(out, max().count());
+        return out.str();
+    }
+
+    namespace detail {
+        u64 default_histogram_shards() noexcept {
+            u64 hw = std::max<u64>(1, std::thread::hardware_concurrency());
+            u64 shards = 1;
+            while (shards < hw && shards < 16) shards <<= 1;
+            return shards;
+        }
+    }
+
+    latency_histogram::latency_histogram(u64 shards) {
+        u64 count = 1;
+        u64 wanted = shards ? shards : detail::default_histogram_shards();
+        while (count < wanted) count <<= 1;
+        this->shards.reset(new shard[count]);
+        mask = count - 1;
+    }
+
+    latency_snapshot latency_histogram::snapshot() const noexcept {
+        latency_snapshot result;
+        for (u64 s = 0; s <= mask; ++s) {
+            const shard& current = shards[s];
+            for (u64 i = 0; i < histogram_layout::bucket_count; ++i) {
+                u64 n = current.counts[i].load(std::memory_order_relaxed);
+                result.counts[i] += n;
+                result.total += n;
+            }
+            result.sum += current.sum.load(std::memory_order_relaxed);
+            result.min_value = std::min(result.min_value, current.min.load(std::memory_order_relaxed));
+            result.max_value = std::max(result.max_value, current.max.load(std::memory_order_relaxed));
+        }
+        // 与记录同时读取时，计数可能已可见而最值尚未更新
+        if (result.total == 0) result.reset();
+        else if (result.min_value > result.max_value) result.min_value = result.max_value;
+        return result;
+    }
+
+    void latency_histogram::reset() noexcept {
+        for (u64 s = 0; s <= mask; ++s) {
+            shard& current = shards[s];
+            for (auto& c : current.counts) c.store(0, std::memory_order_relaxed);
+            current.sum.store(0, std::memory_order_relaxed);
+            current.min.store(~u64(0), std::memory_order_relaxed);
+            current.max.store(0, std::memory_order_relaxed);
+        }
+    }
+}
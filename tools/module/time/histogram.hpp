@@ -0,0 +1,209 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include "time.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace tools::time {
+    // 对数线性分桶（HDR 风格）：每个 2 的幂区间再等分为 32 个子桶，相对误差不超过 1/32
+    // 0 到 63 纳秒每个值单独一桶，可记录的上限约 68.7 秒，超过的值计入最后一桶（最大值仍精确记录）
+    namespace histogram_layout {
+        // 每个 2 的幂区间的子桶数为 2^sub_bucket_bits
+        inline constexpr u32 sub_bucket_bits = 5;
+        inline constexpr u64 sub_bucket_count = u64(1) << sub_bucket_bits;
+        // 可区分的最大值为 2^value_bits - 1 纳秒
+        inline constexpr u32 value_bits = 36;
+        inline constexpr u64 max_value = (u64(1) << value_bits) - 1;
+        inline constexpr u64 bucket_count = (value_bits - sub_bucket_bits + 1) * sub_bucket_count;
+
+        // 值（纳秒）所在的桶
+        constexpr u64 bucket_of(u64 value) noexcept {
+            value = std::min(value, max_value);
+            u32 width = static_cast<u32>(std::bit_width(value));
+            u32 shift = width > sub_bucket_bits + 1 ? width - sub_bucket_bits - 1 : 0;
+            return (u64(shift) << sub_bucket_bits) + (value >> shift);
+        }
+
+        // 桶内最小值
+        constexpr u64 bucket_lower(u64 bucket) noexcept {
+            u64 group = bucket >> sub_bucket_bits;
+            u32 shift = group > 1 ? static_cast<u32>(group - 1) : 0;
+            return (bucket - (u64(shift) << sub_bucket_bits)) << shift;
+        }
+
+        // 桶内最大值
+        constexpr u64 bucket_upper(u64 bucket) noexcept {
+            u64 group = bucket >> sub_bucket_bits;
+            u32 shift = group > 1 ? static_cast<u32>(group - 1) : 0;
+            return bucket_lower(bucket) + (u64(1) << shift) - 1;
+        }
+
+        static_assert(bucket_of(max_value) == bucket_count - 1);
+        static_assert(bucket_upper(bucket_count - 1) == max_value);
+    }
+
+    // 直方图的普通（非并发）副本：由 latency_histogram::snapshot() 生成，可合并、查询分位数
+    class latency_snapshot {
+    public:
+        // 记录一个值（纳秒）
+        void record(u64 value, u64 times = 1) noexcept {
+            if (times == 0) return;
+            counts[histogram_layout::bucket_of(value)] += times;
+            total += times;
+            sum += value * times;
+            min_value = std::min(min_value, value);
+            max_value = std::max(max_value, value);
+        }
+
+        // 合并另一个直方图
+        void merge(const latency_snapshot& other) noexcept;
+
+        void reset() noexcept {
+            *this = latency_snapshot();
+        }
+
+        u64 count() const noexcept {
+            return total;
+        }
+
+        bool empty() const noexcept {
+            return total == 0;
+        }
+
+        tools::time::ns min() const noexcept {
+            return tools::time::ns(total ? static_cast<f64>(min_value) : 0.0);
+        }
+
+        tools::time::ns max() const noexcept {
+            return tools::time::ns(static_cast<f64>(max_value));
+        }
+
+        tools::time::ns mean() const noexcept {
+            return tools::time::ns(total ? static_cast<f64>(sum) / static_cast<f64>(total) : 0.0);
+        }
+
+        // 分位数（percentile 取 0 到 100，如 99.9），返回该分位所在桶的最大值，不超过记录到的最大值
+        // 没有记录时返回 0
+        tools::time::ns percentile(f64 percentile) const noexcept;
+
+        // 单个桶的计数
+        u64 bucket(u64 index) const noexcept {
+            return index < counts.size() ? counts[index] : 0;
+        }
+
+        // 摘要，如 "n 1000  p50 1.2 us  p99 8.5 us  p99.9 12 us  max 15 us"
+        std::string summary() const;
+
+    private:
+        friend class latency_histogram;
+
+        std::array<u64, histogram_layout::bucket_count> counts{};
+        u64 total = 0;
+        u64 sum = 0;
+        u64 min_value = ~u64(0);
+        u64 max_value = 0;
+    };
+
+    namespace detail {
+        // 默认分片数：不小于硬件线程数的 2 的幂，最多 16
+        u64 default_histogram_shards() noexcept;
+
+        // 当前线程使用的分片编号：线程首次使用时轮流分配，之后固定
+        inline u64 histogram_slot() noexcept {
+            static std::atomic<u64> next{ 0 };
+            thread_local u64 slot = next.fetch_add(1, std::memory_order_relaxed);
+            return slot;
+        }
+    }
+
+    // 并发延迟直方图：各线程记录到自己的分片（原子计数，无锁），读取时合并所有分片
+    // 内存固定为 分片数 x 约 8 KiB，记录不分配内存
+    class latency_histogram {
+    public:
+        // shards：分片数（取 2 的幂），0 表示按硬件线程数（最多 16）
+        explicit latency_histogram(u64 shards = 0);
+
+        latency_histogram(const latency_histogram&) = delete;
+        latency_histogram& operator=(const latency_histogram&) = delete;
+
+        // 记录一个值（纳秒）
+        void record(u64 value) noexcept {
+            shard& s = shards[detail::histogram_slot() & mask];
+            s.counts[histogram_layout::bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+            s.sum.fetch_add(value, std::memory_order_relaxed);
+            u64 current = s.max.load(std::memory_order_relaxed);
+            while (value > current && !s.max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            }
+            current = s.min.load(std::memory_order_relaxed);
+            while (value < current && !s.min.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            }
+        }
+
+        // 记录一段时长
+        template<typename Rep, typename Period>
+        void record(std::chrono::duration<Rep, Period> elapsed) noexcept {
+            auto n = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            record(n > 0 ? static_cast<u64>(n) : u64(0));
+        }
+
+        // 记录从 start 到现在的时长
+        void record_since(tools::time::time_point start) noexcept {
+            record(tools::time::time_now() - start);
+        }
+
+        // 合并所有分片（与记录同时进行时不是某一时刻的精确快照）
+        latency_snapshot snapshot() const noexcept;
+
+        // 清空（与记录同时进行时，部分记录可能保留）
+        void reset() noexcept;
+
+        u64 shard_count() const noexcept {
+            return mask + 1;
+        }
+
+    private:
+        struct alignas(64) shard {
+            std::array<std::atomic<u64>, histogram_layout::bucket_count> counts{};
+            std::atomic<u64> sum{ 0 };
+            std::atomic<u64> min{ ~u64(0) };
+            std::atomic<u64> max{ 0 };
+        };
+
+        std::unique_ptr<shard[]> shards;
+        u64 mask = 0;
+    };
+
+    // 作用域计时：析构时把构造以来的时长记录到直方图
+    // 可用于 latency_histogram 与 latency_snapshot
+    template<typename Histogram>
+    class scoped_timer {
+    public:
+        explicit scoped_timer(Histogram& histogram) noexcept
+            : histogram(histogram), start(tools::time::time_now()) {}
+
+        scoped_timer(const scoped_timer&) = delete;
+        scoped_timer& operator=(const scoped_timer&) = delete;
+
+        ~scoped_timer() {
+            auto n = std::chrono::duration_cast<std::chrono::nanoseconds>(tools::time::time_now() - start).count();
+            histogram.record(n > 0 ? static_cast<u64>(n) : u64(0));
+        }
+
+        // 到目前为止的时长
+        tools::time::ns elapsed() const noexcept {
+            return tools::time::time_now() - start;
+        }
+
+    private:
+        Histogram& histogram;
+        tools::time::time_point start;
+    };
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+// 事件追踪
+#include "trace/trace.hpp"
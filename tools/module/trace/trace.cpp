@@ -0,0 +1,266 @@
+#include "trace.hpp"
+
+#include "../time/time.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tools::trace {
+    namespace {
+        // 事件的各字段都是原子变量：导出线程可以与写入线程同时访问同一格
+        struct event {
+            std::atomic<u64> timestamp{ 0 };
+            std::atomic<const char*> category{ nullptr };
+            std::atomic<const char*> name{ nullptr };
+            std::atomic<i64> value{ 0 };
+            std::atomic<u8> ph{ 0 };
+        };
+
+        // 单个线程的环形缓冲区，只有所属线程写入
+        // 写入第 i 个事件前先把 claimed 置为 i + 1（随后的写入会覆盖第 i - capacity 个事件），
+        // 写完后把 head 置为 i + 1；导出时先读 head、再读事件、最后读 claimed，跳过可能已被覆盖的格
+        struct thread_buffer {
+            explicit thread_buffer(u64 capacity, u64 tid)
+                : events(new event[capacity]), mask(capacity - 1), tid(tid) {}
+
+            std::unique_ptr<event[]> events;
+            u64 mask;
+            u64 tid;
+            std::atomic<u64> head{ 0 };
+            std::atomic<u64> claimed{ 0 };
+            // clear() 之前的事件不再导出
+            std::atomic<u64> start{ 0 };
+            std::atomic<bool> exited{ false };
+            // 以下由 registry::mutex 保护
+            std::string name;
+        };
+
+        struct registry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<thread_buffer>> buffers;
+            u64 next_tid = 1;
+            u64 capacity = 1 << 15;
+        };
+
+        // 不析构，其他静态对象析构时仍可记录
+        registry& global() {
+            static registry* r = new registry;
+            return *r;
+        }
+
+        // 线程本地状态，可平凡析构，线程退出后仍可安全访问
+        struct local_state {
+            thread_buffer* buffer;
+            bool dead;
+        };
+
+        thread_local local_state local{};
+        // 注册缓冲区之前设置的线程名
+        thread_local std::string pending_name;
+
+        // 线程退出时标记缓冲区，事件保留到下次 clear()
+        struct buffer_owner {
+            std::shared_ptr<thread_buffer> buffer;
+
+            ~buffer_owner() {
+                if (buffer) buffer->exited.store(true, std::memory_order_release);
+                local.buffer = nullptr;
+                local.dead = true;
+            }
+        };
+
+        thread_buffer* local_buffer() {
+            if (local.buffer || local.dead) return local.buffer;
+            static thread_local buffer_owner owner;
+
+            registry& r = global();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            auto buffer = std::make_shared<thread_buffer>(r.capacity, r.next_tid++);
+            buffer->name = pending_name;
+            r.buffers.push_back(buffer);
+            owner.buffer = buffer;
+            local.buffer = buffer.get();
+            return local.buffer;
+        }
+
+        // 相对进程启动时刻的纳秒数
+        u64 now_ns() noexcept {
+            static const tools::time::time_point start =
+                tools::time::program_startup_time_point::instance().steady_clock_start();
+            auto elapsed = tools::time::time_now() - start;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            return ns > 0 ? static_cast<u64>(ns) : 0;
+        }
+
+        void write_string(std::ostream& out, const char* s) {
+            out << '"';
+            for (; s && *s; ++s) {
+                char c = *s;
+                if (c == '"' || c == '\\') out << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+                else out << c;
+            }
+            out << '"';
+        }
+
+        void write_event(std::ostream& out, u64 tid, char ph, const char* category, const char* name,
+            u64 timestamp, i64 value) {
+            out << "{\"name\":";
+            write_string(out, name);
+            out << ",\"cat\":";
+            write_string(out, category);
+            out << ",\"ph\":\"" << ph << "\",\"ts\":" << timestamp / 1000 << '.'
+                << std::setw(3) << std::setfill('0') << timestamp % 1000 << std::setfill(' ')
+                << ",\"pid\":1,\"tid\":" << tid;
+            if (ph == 'i') out << ",\"s\":\"t\"";
+            if (ph == 'C' || value != 0) out << ",\"args\":{\"value\":" << value << "}";
+            out << "}";
+        }
+    }
+
+    void start() noexcept {
+        // 预先初始化时间基准，避免第一个事件承担其开销
+        tools::time::program_startup_time_point::instance();
+        detail::active.store(true, std::memory_order_relaxed);
+    }
+
+    void stop() noexcept {
+        detail::active.store(false, std::memory_order_relaxed);
+    }
+
+    void clear() {
+        registry& r = global();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::erase_if(r.buffers, [](const std::shared_ptr<thread_buffer>& b) {
+            return b->exited.load(std::memory_order_acquire);
+        });
+        for (auto& b : r.buffers) {
+            b->start.store(b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+    }
+
+    void set_buffer_capacity(u64 events) {
+        u64 capacity = 16;
+        while (capacity < events) capacity <<= 1;
+        registry& r = global();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.capacity = capacity;
+    }
+
+    void set_thread_name(const std::string& name) {
+        if (local.dead) return;
+        if (!local.buffer) {
+            pending_name = name;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(global().mutex);
+        local.buffer->name = name;
+    }
+
+    void record(phase ph, const char* category, const char* name, i64 value) noexcept {
+        thread_buffer* b = nullptr;
+        try {
+            b = local_buffer();
+        }
+        catch (...) {
+            return;
+        }
+        if (!b) return;
+
+        u64 index = b->head.load(std::memory_order_relaxed);
+        b->claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        event& e = b->events[index & b->mask];
+        e.timestamp.store(now_ns(), std::memory_order_relaxed);
+        e.category.store(category, std::memory_order_relaxed);
+        e.name.store(name, std::memory_order_relaxed);
+        e.value.store(value, std::memory_order_relaxed);
+        e.ph.store(static_cast<u8>(ph), std::memory_order_relaxed);
+        b->head.store(index + 1, std::memory_order_release);
+    }
+
+    void write_chrome_json(std::ostream& out) {
+        registry& r = global();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        auto separator = [&] {
+            out << (first ? "\n" : ",\n");
+            first = false;
+        };
+
+        struct copied {
+            u64 timestamp;
+            const char* category;
+            const char* name;
+            i64 value;
+            char ph;
+        };
+        std::vector<copied> events;
+
+        for (auto& b : r.buffers) {
+            if (!b->name.empty()) {
+                separator();
+                out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid << ",\"args\":{\"name\":";
+                write_string(out, b->name.c_str());
+                out << "}}";
+            }
+
+            u64 capacity = b->mask + 1;
+            u64 head = b->head.load(std::memory_order_acquire);
+            u64 from = std::max(b->start.load(std::memory_order_relaxed), head > capacity ? head - capacity : 0);
+
+            events.clear();
+            for (u64 i = from; i < head; ++i) {
+                const event& e = b->events[i & b->mask];
+                events.push_back({
+                    e.timestamp.load(std::memory_order_relaxed),
+                    e.category.load(std::memory_order_relaxed),
+                    e.name.load(std::memory_order_relaxed),
+                    e.value.load(std::memory_order_relaxed),
+                    static_cast<char>(e.ph.load(std::memory_order_relaxed)) });
+            }
+
+            // 复制期间被写入线程占用的格可能已是新事件，丢弃
+            std::atomic_thread_fence(std::memory_order_acquire);
+            u64 claimed = b->claimed.load(std::memory_order_relaxed);
+            u64 valid_from = claimed > capacity ? claimed - capacity : 0;
+
+            for (u64 i = from; i < head; ++i) {
+                if (i < valid_from) continue;
+                const copied& e = events[i - from];
+                separator();
+                write_event(out, b->tid, e.ph, e.category, e.name, e.timestamp, e.value);
+            }
+        }
+        out << "\n]}\n";
+    }
+
+    bool dump(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) return false;
+        write_chrome_json(out);
+        return static_cast<bool>(out);
+    }
+
+    trace_stats stats() {
+        registry& r = global();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        trace_stats s;
+        s.threads = r.buffers.size();
+        for (auto& b : r.buffers) {
+            u64 head = b->head.load(std::memory_order_relaxed);
+            u64 capacity = b->mask + 1;
+            s.recorded += head;
+            s.overwritten += head > capacity ? head - capacity : 0;
+        }
+        return s;
+    }
+}
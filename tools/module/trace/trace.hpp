@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../../base.hpp"
+
+#include <atomic>
+#include <ostream>
+#include <string>
+
+// 编译期开关：定义 TOOLS_TRACE_ENABLED=1（CMake 选项 TOOLS_BOX_TRACE）时埋点宏才生成代码，
+// 否则宏展开为空，不产生任何开销；下面的函数接口始终可用
+#ifndef TOOLS_TRACE_ENABLED
+#define TOOLS_TRACE_ENABLED 0
+#endif
+
+namespace tools::trace {
+    // 事件类型，取值为 Chrome trace 格式中的 ph 字段
+    enum class phase : u8 {
+        begin = 'B',
+        end = 'E',
+        counter = 'C',
+        instant = 'i',
+    };
+
+    // 追踪统计信息
+    struct trace_stats {
+        // 注册过缓冲区的线程数（含已退出、尚未清除的线程）
+        u64 threads = 0;
+        // 累计记录的事件数
+        u64 recorded = 0;
+        // 因缓冲区写满而被覆盖的事件数
+        u64 overwritten = 0;
+    };
+
+    namespace detail {
+        inline std::atomic<bool> active{ false };
+    }
+
+    // 开始、停止记录（编译期开关打开时埋点才会记录）
+    void start() noexcept;
+    void stop() noexcept;
+
+    inline bool enabled() noexcept {
+        return detail::active.load(std::memory_order_relaxed);
+    }
+
+    // 丢弃已记录的事件，并释放已退出线程的缓冲区
+    void clear();
+
+    // 每个线程的环形缓冲区可容纳的事件数（取 2 的幂），只影响之后首次记录的线程；默认 32768
+    // 缓冲区写满后覆盖最旧的事件
+    void set_buffer_capacity(u64 events);
+
+    // 当前线程在追踪视图中显示的名称
+    void set_thread_name(const std::string& name);
+
+    // 在当前线程的缓冲区中记录一个事件，时间戳取自 tools::time::time_now()
+    // category 与 name 须为生命周期覆盖导出时刻的字符串（通常是字面量）
+    void record(phase ph, const char* category, const char* name, i64 value = 0) noexcept;
+
+    // 正在记录时才写入事件
+    inline void emit(phase ph, const char* category, const char* name, i64 value = 0) noexcept {
+        if (enabled()) record(ph, category, name, value);
+    }
+
+    // 作用域事件：构造时记录开始，析构时记录结束
+    class scope {
+    public:
+        scope(const char* category, const char* name, i64 value = 0) noexcept
+            : category(category), name(name), active(enabled()) {
+            if (active) record(phase::begin, category, name, value);
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+        ~scope() {
+            if (active) record(phase::end, category, name);
+        }
+
+    private:
+        const char* category;
+        const char* name;
+        bool active;
+    };
+
+    // 以 Chrome trace / Perfetto 可读的 JSON 格式导出所有线程的事件
+    // 可在记录过程中导出，正在被覆盖的事件会被跳过
+    void write_chrome_json(std::ostream& out);
+
+    // 导出到文件，失败返回 false
+    bool dump(const std::string& path);
+
+    trace_stats stats();
+}
+
+#define TOOLS_TRACE_CONCAT_INNER(a, b) a##b
+#define TOOLS_TRACE_CONCAT(a, b) TOOLS_TRACE_CONCAT_INNER(a, b)
+
+#if TOOLS_TRACE_ENABLED
+// 作用域事件
+#define TOOLS_TRACE_SCOPE(category, name) \
+    ::tools::trace::scope TOOLS_TRACE_CONCAT(tools_trace_scope_, __LINE__)(category, name)
+// 带数值参数的作用域事件
+#define TOOLS_TRACE_SCOPE_ARG(category, name, value) \
+    ::tools::trace::scope TOOLS_TRACE_CONCAT(tools_trace_scope_, __LINE__)(category, name, static_cast<i64>(value))
+#define TOOLS_TRACE_BEGIN(category, name) \
+    ::tools::trace::emit(::tools::trace::phase::begin, category, name)
+#define TOOLS_TRACE_END(category, name) \
+    ::tools::trace::emit(::tools::trace::phase::end, category, name)
+// 瞬时事件
+#define TOOLS_TRACE_INSTANT(category, name, value) \
+    ::tools::trace::emit(::tools::trace::phase::instant, category, name, static_cast<i64>(value))
+// 计数器事件
+#define TOOLS_TRACE_COUNTER(category, name, value) \
+    ::tools::trace::emit(::tools::trace::phase::counter, category, name, static_cast<i64>(value))
+#else
+#define TOOLS_TRACE_SCOPE(category, name) ((void)0)
+#define TOOLS_TRACE_SCOPE_ARG(category, name, value) ((void)0)
+#define TOOLS_TRACE_BEGIN(category, name) ((void)0)
+#define TOOLS_TRACE_END(category, name) ((void)0)
+#define TOOLS_TRACE_INSTANT(category, name, value) ((void)0)
+#define TOOLS_TRACE_COUNTER(category, name, value) ((void)0)
+#endif